@@ -0,0 +1,190 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "effect/animationtable_p.h"
+
+#include <QTest>
+
+using namespace std::chrono_literals;
+using namespace KWin;
+
+class AnimationTableTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testAdd();
+    void testRemoveAnimation();
+    void testRemoveWindow();
+    void testFinished();
+    void benchmarkFrame();
+};
+
+static EffectWindow *fakeWindow(quintptr id)
+{
+    // AnimationTable never dereferences the windows, so any distinct pointer will do.
+    return reinterpret_cast<EffectWindow *>(id * 16);
+}
+
+static AniData makeAnimation(quint64 id, std::chrono::milliseconds duration, qint64 startTime = 0)
+{
+    AniData animation;
+    animation.id = id;
+    animation.startTime = startTime;
+    animation.terminationFlags = AnimationEffect::TerminateAtSource | AnimationEffect::TerminateAtTarget;
+    animation.timeLine.setDuration(duration);
+    return animation;
+}
+
+static void advanceAll(AnimationTable &table, std::chrono::milliseconds presentTime, qint64 now)
+{
+    for (AnimationTable::Entry &entry : table) {
+        AnimationTable::advance(entry, presentTime, now);
+    }
+}
+
+void AnimationTableTest::testAdd()
+{
+    AnimationTable table;
+    QVERIFY(table.isEmpty());
+
+    table.add(fakeWindow(1), makeAnimation(1, 100ms));
+    table.add(fakeWindow(2), makeAnimation(2, 100ms));
+    table.add(fakeWindow(1), makeAnimation(3, 100ms));
+    QCOMPARE(table.count(), 2);
+    QVERIFY(table.contains(fakeWindow(1)));
+    QVERIFY(!table.contains(fakeWindow(3)));
+
+    // The animations of a window are in the order they were added.
+    const AnimationTable::Entry *entry = table.find(fakeWindow(1));
+    QVERIFY(entry);
+    QCOMPARE(entry->window, fakeWindow(1));
+    QCOMPARE(entry->animations.count(), 2);
+    QCOMPARE(entry->animations[0].id, quint64(1));
+    QCOMPARE(entry->animations[1].id, quint64(3));
+
+    AnimationTable::Entry *owner = nullptr;
+    const AniData *animation = table.animation(2, &owner);
+    QVERIFY(animation);
+    QCOMPARE(animation->id, quint64(2));
+    QCOMPARE(owner->window, fakeWindow(2));
+    QVERIFY(!table.animation(4));
+}
+
+void AnimationTableTest::testRemoveAnimation()
+{
+    AnimationTable table;
+    table.add(fakeWindow(1), makeAnimation(1, 100ms));
+    table.add(fakeWindow(1), makeAnimation(2, 100ms));
+
+    table.remove(1);
+    QVERIFY(!table.animation(1));
+    QVERIFY(table.animation(2));
+
+    // The entry of the window stays around, it's up to the effect to release the window.
+    table.remove(2);
+    QVERIFY(!table.animation(2));
+    QVERIFY(table.contains(fakeWindow(1)));
+    QVERIFY(table.find(fakeWindow(1))->animations.isEmpty());
+
+    // Removing an unknown animation is harmless.
+    table.remove(2);
+    QCOMPARE(table.count(), 1);
+}
+
+void AnimationTableTest::testRemoveWindow()
+{
+    AnimationTable table;
+    table.add(fakeWindow(1), makeAnimation(1, 100ms));
+    table.add(fakeWindow(2), makeAnimation(2, 100ms));
+    table.add(fakeWindow(3), makeAnimation(3, 100ms));
+    table.add(fakeWindow(3), makeAnimation(4, 100ms));
+
+    // The last window takes the place of the removed one, its animations can still be found.
+    table.remove(fakeWindow(1));
+    QCOMPARE(table.count(), 2);
+    QVERIFY(!table.contains(fakeWindow(1)));
+    QVERIFY(!table.animation(1));
+    AnimationTable::Entry *owner = nullptr;
+    QVERIFY(table.animation(4, &owner));
+    QCOMPARE(owner->window, fakeWindow(3));
+    QCOMPARE(table.find(fakeWindow(3))->animations.count(), 2);
+    QCOMPARE(table.find(fakeWindow(2))->animations[0].id, quint64(2));
+
+    table.remove(fakeWindow(3));
+    table.remove(fakeWindow(2));
+    QVERIFY(table.isEmpty());
+    QVERIFY(!table.animation(2));
+}
+
+void AnimationTableTest::testFinished()
+{
+    AnimationTable table;
+    table.add(fakeWindow(1), makeAnimation(1, 100ms));
+    table.add(fakeWindow(1), makeAnimation(2, 200ms));
+    // Starts later, its time line doesn't move until then.
+    table.add(fakeWindow(2), makeAnimation(3, 50ms, 1000));
+
+    advanceAll(table, 0ms, 0);
+    advanceAll(table, 150ms, 0);
+    QCOMPARE(table.finished(0), QList<quint64>{1});
+    QCOMPARE(table.find(fakeWindow(2))->animations[0].timeLine.elapsed(), 0ms);
+
+    advanceAll(table, 250ms, 1000);
+    QCOMPARE(table.finished(1000), (QList<quint64>{1, 2}));
+
+    advanceAll(table, 300ms, 1000);
+    QCOMPARE(table.finished(1000), (QList<quint64>{1, 2, 3}));
+}
+
+void AnimationTableTest::benchmarkFrame()
+{
+    // 500 animations on 100 windows, every animation that ends is followed by another one,
+    // as effects do from animationEnded()
+    constexpr int windowCount = 100;
+    constexpr int animationCount = 500;
+
+    AnimationTable table;
+    quint64 nextId = 1;
+    for (int i = 0; i < animationCount; ++i) {
+        table.add(fakeWindow(1 + i % windowCount), makeAnimation(nextId++, std::chrono::milliseconds(100 + i % 200)));
+    }
+
+    std::chrono::milliseconds presentTime = 0ms;
+    QBENCHMARK {
+        presentTime += 16ms;
+
+        // What prePaintWindow() and paintWindow() do for every painted window
+        for (int i = 0; i < windowCount; ++i) {
+            AnimationTable::Entry *entry = table.find(fakeWindow(1 + i));
+            Q_ASSERT(entry);
+            AnimationTable::advance(*entry, presentTime, presentTime.count());
+            qreal progress = 0;
+            for (const AniData &animation : entry->animations) {
+                progress += animation.timeLine.value();
+            }
+            Q_UNUSED(progress)
+        }
+
+        const QList<quint64> finished = table.finished(presentTime.count());
+        for (const quint64 id : finished) {
+            AnimationTable::Entry *entry;
+            const AniData *animation = table.animation(id, &entry);
+            EffectWindow *window = entry->window;
+            const std::chrono::milliseconds duration = animation->timeLine.duration();
+            table.remove(id);
+            table.add(window, makeAnimation(nextId++, duration, presentTime.count()));
+        }
+    }
+
+    QCOMPARE(table.count(), windowCount);
+}
+
+QTEST_GUILESS_MAIN(AnimationTableTest)
+#include "animationtabletest.moc"
@@ -0,0 +1,503 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/itemgeometry.h"
+#include "wobblymesh.h"
+
+#include <QTest>
+
+#include <cmath>
+
+using namespace KWin;
+
+namespace
+{
+
+/**
+ * The spring mesh as the wobbly windows effect used to simulate it, with a list of points
+ * per property and a grid of doubles in the screen space.
+ */
+class ScalarMesh
+{
+public:
+    struct Pair
+    {
+        qreal x;
+        qreal y;
+    };
+
+    void reset(const QRectF &geometry)
+    {
+        origin = makeGrid(geometry);
+        position = origin;
+        velocity.fill(Pair{0.0, 0.0}, WobblyMesh::Count);
+        acceleration.fill(Pair{0.0, 0.0}, WobblyMesh::Count);
+        buffer.fill(Pair{0.0, 0.0}, WobblyMesh::Count);
+        constraint.fill(false, WobblyMesh::Count);
+    }
+
+    void setConstrained(int index, bool constrained)
+    {
+        constraint[index] = constrained;
+    }
+
+    void setVelocity(int index, const QPointF &v)
+    {
+        velocity[index] = {v.x(), v.y()};
+    }
+
+    WobblyMesh::Energy step(const QRectF &geometry, qreal time, const WobblyMesh::Parameters &parameters, Qt::Edges wobblyEdges)
+    {
+        const int width = WobblyMesh::Width;
+        const int height = WobblyMesh::Height;
+        const qreal xLength = geometry.width() / (width - 1.0);
+        const qreal yLength = geometry.height() / (height - 1.0);
+
+        origin = makeGrid(geometry);
+
+        for (int j = 0; j < height; ++j) {
+            for (int i = 0; i < width; ++i) {
+                const int index = j * width + i;
+                if (constraint[index]) {
+                    acceleration[index] = {(origin[index].x - position[index].x) * parameters.stiffness, (origin[index].y - position[index].y) * parameters.stiffness};
+                    continue;
+                }
+
+                const Pair &pos = position[index];
+                Pair acc = {0.0, 0.0};
+                int springs = 0;
+                if (i > 0) {
+                    acc.x += (xLength - (pos.x - position[index - 1].x)) * parameters.stiffness;
+                    acc.y += (position[index - 1].y - pos.y) * parameters.stiffness;
+                    ++springs;
+                }
+                if (i < width - 1) {
+                    acc.x += ((position[index + 1].x - pos.x) - xLength) * parameters.stiffness;
+                    acc.y += (position[index + 1].y - pos.y) * parameters.stiffness;
+                    ++springs;
+                }
+                if (j > 0) {
+                    acc.x += (position[index - width].x - pos.x) * parameters.stiffness;
+                    acc.y += (yLength - (pos.y - position[index - width].y)) * parameters.stiffness;
+                    ++springs;
+                }
+                if (j < height - 1) {
+                    acc.x += (position[index + width].x - pos.x) * parameters.stiffness;
+                    acc.y += ((position[index + width].y - pos.y) - yLength) * parameters.stiffness;
+                    ++springs;
+                }
+                acceleration[index] = {acc.x / springs, acc.y / springs};
+            }
+        }
+
+        heightRingLinearMean(acceleration);
+
+        qreal accelerationSum = 0.0;
+        for (int i = 0; i < WobblyMesh::Count; ++i) {
+            Pair acc = acceleration[i];
+            fixVectorBounds(acc, parameters.minAcceleration, parameters.maxAcceleration);
+            Pair &vel = velocity[i];
+            vel.x = acc.x * time + vel.x * parameters.drag;
+            vel.y = acc.y * time + vel.y * parameters.drag;
+            accelerationSum += std::fabs(acc.x) + std::fabs(acc.y);
+        }
+
+        heightRingLinearMean(velocity);
+
+        qreal velocitySum = 0.0;
+        for (int i = 0; i < WobblyMesh::Count; ++i) {
+            Pair &pos = position[i];
+            Pair &vel = velocity[i];
+            fixVectorBounds(vel, parameters.minVelocity, parameters.maxVelocity);
+            pos.x += vel.x * time * parameters.moveFactor;
+            pos.y += vel.y * time * parameters.moveFactor;
+            velocitySum += std::fabs(vel.x) + std::fabs(vel.y);
+        }
+
+        for (int j = 0; j < height; ++j) {
+            for (int i = 0; i < width; ++i) {
+                const int index = j * width + i;
+                if ((!(wobblyEdges & Qt::TopEdge) && j != height - 1) || (!(wobblyEdges & Qt::BottomEdge) && j != 0)) {
+                    position[index].y = origin[index].y;
+                }
+                if ((!(wobblyEdges & Qt::LeftEdge) && i != width - 1) || (!(wobblyEdges & Qt::RightEdge) && i != 0)) {
+                    position[index].x = origin[index].x;
+                }
+            }
+        }
+
+        return WobblyMesh::Energy{
+            .acceleration = accelerationSum,
+            .velocity = velocitySum,
+        };
+    }
+
+    QPointF map(qreal u, qreal v) const
+    {
+        const qreal px[4] = {(1 - u) * (1 - u) * (1 - u), 3 * (1 - u) * (1 - u) * u, 3 * (1 - u) * u * u, u * u * u};
+        const qreal py[4] = {(1 - v) * (1 - v) * (1 - v), 3 * (1 - v) * (1 - v) * v, 3 * (1 - v) * v * v, v * v * v};
+
+        Pair res = {0.0, 0.0};
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 4; ++i) {
+                res.x += px[i] * py[j] * position[i + j * WobblyMesh::Width].x;
+                res.y += px[i] * py[j] * position[i + j * WobblyMesh::Width].y;
+            }
+        }
+        return QPointF(res.x, res.y);
+    }
+
+    void deform(WindowQuadList &quads, const QSizeF &size, const QPointF &origin) const
+    {
+        for (int i = 0; i < quads.count(); ++i) {
+            for (int j = 0; j < 4; ++j) {
+                WindowVertex &v = quads[i][j];
+                const QPointF newPos = map(v.x() / size.width(), v.y() / size.height());
+                v.move(newPos.x() - origin.x(), newPos.y() - origin.y());
+            }
+        }
+    }
+
+private:
+    static QList<Pair> makeGrid(const QRectF &geometry)
+    {
+        QList<Pair> grid(WobblyMesh::Count);
+        Pair value = {geometry.x(), geometry.y()};
+        for (int j = 0; j < WobblyMesh::Height; ++j) {
+            for (int i = 0; i < WobblyMesh::Width; ++i) {
+                grid[j * WobblyMesh::Width + i] = value;
+                if (i != WobblyMesh::Width - 2) {
+                    value.x += geometry.width() / (WobblyMesh::Width - 1.0);
+                } else {
+                    value.x = geometry.width() + geometry.x();
+                }
+            }
+            value.x = geometry.x();
+            if (j != WobblyMesh::Height - 2) {
+                value.y += geometry.height() / (WobblyMesh::Height - 1.0);
+            } else {
+                value.y = geometry.height() + geometry.y();
+            }
+        }
+        return grid;
+    }
+
+    static void fixVectorBounds(Pair &vec, qreal min, qreal max)
+    {
+        for (qreal *value : {&vec.x, &vec.y}) {
+            if (std::fabs(*value) < min) {
+                *value = 0.0;
+            } else if (std::fabs(*value) > max) {
+                *value = *value > 0.0 ? max : -max;
+            }
+        }
+    }
+
+    void heightRingLinearMean(QList<Pair> &data)
+    {
+        const int width = WobblyMesh::Width;
+        const int height = WobblyMesh::Height;
+        for (int j = 0; j < height; ++j) {
+            for (int i = 0; i < width; ++i) {
+                Pair sum = {0.0, 0.0};
+                int neighbours = 0;
+                for (int y = std::max(0, j - 1); y <= std::min(height - 1, j + 1); ++y) {
+                    for (int x = std::max(0, i - 1); x <= std::min(width - 1, i + 1); ++x) {
+                        if (x != i || y != j) {
+                            sum.x += data[y * width + x].x;
+                            sum.y += data[y * width + x].y;
+                            ++neighbours;
+                        }
+                    }
+                }
+                const Pair &self = data[j * width + i];
+                buffer[j * width + i] = {(sum.x + neighbours * self.x) / (2.0 * neighbours), (sum.y + neighbours * self.y) / (2.0 * neighbours)};
+            }
+        }
+
+        auto tmp = data;
+        data = buffer;
+        buffer = tmp;
+    }
+
+    QList<Pair> origin;
+    QList<Pair> position;
+    QList<Pair> velocity;
+    QList<Pair> acceleration;
+    QList<Pair> buffer;
+    QList<bool> constraint;
+};
+
+enum class Scenario {
+    Drag,
+    Throb,
+    Resize,
+};
+
+struct Frame
+{
+    QRectF geometry;
+    Qt::Edges wobblyEdges;
+};
+
+// The first set of parameters of the effect, it's the most lively one
+static const WobblyMesh::Parameters s_parameters{
+    .stiffness = 0.15,
+    .drag = 0.80,
+    .moveFactor = 0.10,
+    .minVelocity = 0.0,
+    .maxVelocity = 1000.0,
+    .minAcceleration = 0.0,
+    .maxAcceleration = 1000.0,
+};
+
+static constexpr int s_stepCount = 200;
+static constexpr qreal s_stepTime = 10;
+
+static Frame frame(Scenario scenario, int step)
+{
+    switch (scenario) {
+    case Scenario::Drag:
+        // Fling the window across a large output for half of the time, then let it settle
+        return Frame{
+            .geometry = QRectF(QPointF(3000, 1500) + QPointF(12, 7) * std::min(step, s_stepCount / 2), QSizeF(800, 600)),
+            .wobblyEdges = Qt::TopEdge | Qt::LeftEdge | Qt::RightEdge | Qt::BottomEdge,
+        };
+    case Scenario::Throb:
+        return Frame{
+            .geometry = QRectF(0, 0, 1920, 1080),
+            .wobblyEdges = Qt::TopEdge | Qt::LeftEdge | Qt::RightEdge | Qt::BottomEdge,
+        };
+    case Scenario::Resize:
+        // Only the bottom-right corner moves, the other sides are pinned
+        return Frame{
+            .geometry = QRectF(QPointF(100, 100), QSizeF(400, 300) + QSizeF(6, 4) * std::min(step, s_stepCount / 2)),
+            .wobblyEdges = Qt::RightEdge | Qt::BottomEdge,
+        };
+    }
+    Q_UNREACHABLE();
+}
+
+template<typename Mesh>
+static void setUp(Mesh &mesh, Scenario scenario)
+{
+    mesh.reset(frame(scenario, 0).geometry);
+    switch (scenario) {
+    case Scenario::Drag:
+        // Picked at the top-left corner
+        mesh.setConstrained(0, true);
+        break;
+    case Scenario::Throb:
+        for (int j = 0; j < WobblyMesh::Height; ++j) {
+            for (int i = 0; i < WobblyMesh::Width; ++i) {
+                const int index = j * WobblyMesh::Width + i;
+                mesh.setVelocity(index, QPointF(-30 * (i / qreal(WobblyMesh::Width - 1) - 0.5), -30 * (j / qreal(WobblyMesh::Height - 1) - 0.5)));
+                if (i > 0 && i < WobblyMesh::Width - 1 && j > 0 && j < WobblyMesh::Height - 1) {
+                    mesh.setConstrained(index, true);
+                }
+            }
+        }
+        break;
+    case Scenario::Resize:
+        mesh.setConstrained(WobblyMesh::Count - 1, true);
+        break;
+    }
+}
+
+static WindowQuadList makeGrid(const QSizeF &size)
+{
+    WindowQuad quad;
+    quad[0] = WindowVertex(0, 0, 0, 0);
+    quad[1] = WindowVertex(size.width(), 0, 1, 0);
+    quad[2] = WindowVertex(size.width(), size.height(), 1, 1);
+    quad[3] = WindowVertex(0, size.height(), 0, 1);
+
+    WindowQuadList quads;
+    quads.append(quad);
+    // The default tesselation of the effect
+    return quads.makeRegularGrid(20, 20);
+}
+
+} // namespace
+
+Q_DECLARE_METATYPE(Scenario)
+
+class WobblyMeshTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testStep_data();
+    void testStep();
+    void testDeform_data();
+    void testDeform();
+    void benchmarkStep_data();
+    void benchmarkStep();
+    void benchmarkDeform_data();
+    void benchmarkDeform();
+};
+
+static void addScenarios()
+{
+    QTest::addColumn<Scenario>("scenario");
+
+    QTest::addRow("drag") << Scenario::Drag;
+    QTest::addRow("throb") << Scenario::Throb;
+    QTest::addRow("resize") << Scenario::Resize;
+}
+
+void WobblyMeshTest::testStep_data()
+{
+    addScenarios();
+}
+
+void WobblyMeshTest::testStep()
+{
+    // The mesh computes with floats, it only has to stay within a fraction of a pixel
+    // of the scalar simulation
+    QFETCH(Scenario, scenario);
+
+    WobblyMesh mesh;
+    setUp(mesh, scenario);
+    ScalarMesh reference;
+    setUp(reference, scenario);
+
+    for (int step = 1; step <= s_stepCount; ++step) {
+        const Frame current = frame(scenario, step);
+        const WobblyMesh::Energy energy = mesh.step(current.geometry, s_stepTime, s_parameters, current.wobblyEdges);
+        const WobblyMesh::Energy expectedEnergy = reference.step(current.geometry, s_stepTime, s_parameters, current.wobblyEdges);
+
+        QVERIFY2(std::abs(energy.acceleration - expectedEnergy.acceleration) <= 0.01 + expectedEnergy.acceleration * 1e-3, qPrintable(QStringLiteral("step %1").arg(step)));
+        QVERIFY2(std::abs(energy.velocity - expectedEnergy.velocity) <= 0.01 + expectedEnergy.velocity * 1e-3, qPrintable(QStringLiteral("step %1").arg(step)));
+
+        for (int j = 0; j < WobblyMesh::Height; ++j) {
+            for (int i = 0; i < WobblyMesh::Width; ++i) {
+                const QPointF u(i / qreal(WobblyMesh::Width - 1), j / qreal(WobblyMesh::Height - 1));
+                const QPointF point = mesh.map(u.x(), u.y());
+                const QPointF expected = reference.map(u.x(), u.y());
+                QVERIFY2((point - expected).manhattanLength() < 0.05, qPrintable(QStringLiteral("step %1, point %2").arg(step).arg(j * WobblyMesh::Width + i)));
+            }
+        }
+    }
+
+    // Every scenario ends at rest
+    const WobblyMesh::Energy energy = mesh.step(frame(scenario, s_stepCount).geometry, s_stepTime, s_parameters, frame(scenario, s_stepCount).wobblyEdges);
+    QVERIFY(energy.velocity < 0.5);
+}
+
+void WobblyMeshTest::testDeform_data()
+{
+    addScenarios();
+}
+
+void WobblyMeshTest::testDeform()
+{
+    QFETCH(Scenario, scenario);
+
+    WobblyMesh mesh;
+    setUp(mesh, scenario);
+    ScalarMesh reference;
+    setUp(reference, scenario);
+
+    // Stop in the middle of the animation, when the mesh is bent the most
+    for (int step = 1; step <= 20; ++step) {
+        const Frame current = frame(scenario, step);
+        mesh.step(current.geometry, s_stepTime, s_parameters, current.wobblyEdges);
+        reference.step(current.geometry, s_stepTime, s_parameters, current.wobblyEdges);
+    }
+
+    const QRectF geometry = frame(scenario, 20).geometry;
+    WindowQuadList quads = makeGrid(geometry.size());
+    WindowQuadList expectedQuads = quads;
+    mesh.deform(quads, geometry.size(), geometry.topLeft());
+    reference.deform(expectedQuads, geometry.size(), geometry.topLeft());
+
+    QCOMPARE(quads.count(), expectedQuads.count());
+    for (int i = 0; i < quads.count(); ++i) {
+        for (int j = 0; j < 4; ++j) {
+            QVERIFY(std::abs(quads[i][j].x() - expectedQuads[i][j].x()) < 0.05);
+            QVERIFY(std::abs(quads[i][j].y() - expectedQuads[i][j].y()) < 0.05);
+            QCOMPARE(quads[i][j].u(), expectedQuads[i][j].u());
+            QCOMPARE(quads[i][j].v(), expectedQuads[i][j].v());
+        }
+    }
+}
+
+void WobblyMeshTest::benchmarkStep_data()
+{
+    QTest::addColumn<bool>("scalar");
+
+    QTest::addRow("scalar") << true;
+    QTest::addRow("mesh") << false;
+}
+
+void WobblyMeshTest::benchmarkStep()
+{
+    // A window dragged around for two seconds
+    QFETCH(bool, scalar);
+
+    if (scalar) {
+        QBENCHMARK {
+            ScalarMesh reference;
+            setUp(reference, Scenario::Drag);
+            for (int step = 1; step <= s_stepCount; ++step) {
+                const Frame current = frame(Scenario::Drag, step);
+                reference.step(current.geometry, s_stepTime, s_parameters, current.wobblyEdges);
+            }
+        }
+    } else {
+        QBENCHMARK {
+            WobblyMesh mesh;
+            setUp(mesh, Scenario::Drag);
+            for (int step = 1; step <= s_stepCount; ++step) {
+                const Frame current = frame(Scenario::Drag, step);
+                mesh.step(current.geometry, s_stepTime, s_parameters, current.wobblyEdges);
+            }
+        }
+    }
+}
+
+void WobblyMeshTest::benchmarkDeform_data()
+{
+    benchmarkStep_data();
+}
+
+void WobblyMeshTest::benchmarkDeform()
+{
+    QFETCH(bool, scalar);
+
+    const QRectF geometry = frame(Scenario::Drag, 20).geometry;
+    const WindowQuadList grid = makeGrid(geometry.size());
+
+    if (scalar) {
+        ScalarMesh reference;
+        setUp(reference, Scenario::Drag);
+        for (int step = 1; step <= 20; ++step) {
+            const Frame current = frame(Scenario::Drag, step);
+            reference.step(current.geometry, s_stepTime, s_parameters, current.wobblyEdges);
+        }
+        QBENCHMARK {
+            WindowQuadList quads = grid;
+            reference.deform(quads, geometry.size(), geometry.topLeft());
+        }
+    } else {
+        WobblyMesh mesh;
+        setUp(mesh, Scenario::Drag);
+        for (int step = 1; step <= 20; ++step) {
+            const Frame current = frame(Scenario::Drag, step);
+            mesh.step(current.geometry, s_stepTime, s_parameters, current.wobblyEdges);
+        }
+        QBENCHMARK {
+            WindowQuadList quads = grid;
+            mesh.deform(quads, geometry.size(), geometry.topLeft());
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(WobblyMeshTest)
+#include "wobblymeshtest.moc"
@@ -840,6 +840,13 @@ public:
         stream->init(stream_window(uuid, mode));
         return stream;
     }
+
+    ScreencastingStreamV1 *createRegionStream(const QRect &region, qreal scale, pointer mode)
+    {
+        auto stream = new ScreencastingStreamV1(this);
+        stream->init(stream_region(region.x(), region.y(), region.width(), region.height(), wl_fixed_from_double(scale), mode));
+        return stream;
+    }
 };
 
 struct OutputInfo
@@ -84,6 +84,7 @@ private Q_SLOTS:
     void init();
     void testWindowCasting();
     void testOutputCasting();
+    void testRegionCasting();
 
 private:
     std::optional<QImage> oneFrameAndClose(Test::ScreencastingStreamV1 *stream);
@@ -176,6 +177,61 @@ void ScreencastingTest::testOutputCasting()
     QCOMPAREIMG(*img, sourceImage, QLatin1String("output_cast"));
 }
 
+void ScreencastingTest::testRegionCasting()
+{
+    // the region doesn't start at the origin of the output, so damage has to be mapped into the stream
+    auto theOutput = KWin::Test::waylandOutputs().constFirst();
+
+    std::unique_ptr<KWayland::Client::Surface> surface(Test::createSurface());
+    QVERIFY(surface != nullptr);
+
+    std::unique_ptr<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.get()));
+    QVERIFY(shellSurface != nullptr);
+
+    QImage sourceImage(theOutput->pixelSize(), QImage::Format_RGBA8888_Premultiplied);
+    sourceImage.fill(Qt::green);
+
+    Window *window = Test::renderAndWaitForShown(surface.get(), sourceImage);
+    QVERIFY(window);
+    QCOMPARE(window->frameGeometry(), window->output()->geometry());
+
+    const QRect region(100, 100, 100, 100);
+    auto stream = KWin::Test::screencasting()->createRegionStream(region, 1, QtWayland::zkde_screencast_unstable_v1::pointer_hidden);
+
+    PipeWireSourceStream pwStream;
+    connect(stream, &Test::ScreencastingStreamV1::failed, qGuiApp, [](const QString &error) {
+        qDebug() << "stream failed with error" << error;
+        Q_ASSERT(false);
+    });
+    connect(stream, &Test::ScreencastingStreamV1::created, qGuiApp, [&pwStream](quint32 nodeId) {
+        pwStream.createStream(nodeId, 0);
+    });
+
+    std::optional<QImage> img;
+    connect(&pwStream, &PipeWireSourceStream::frameReceived, qGuiApp, [&img](const PipeWireFrame &frame) {
+        if (frame.image) {
+            img = frame.image->convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+        }
+    });
+
+    QImage expected(region.size(), QImage::Format_RGBA8888_Premultiplied);
+    expected.fill(Qt::green);
+    QTRY_VERIFY(img && *img == expected);
+
+    // damage only the captured area
+    {
+        QPainter p(&sourceImage);
+        p.fillRect(region, Qt::red);
+    }
+    surface->attachBuffer(Test::waylandShmPool()->createBuffer(sourceImage));
+    surface->damage(region);
+    surface->commit(KWayland::Client::Surface::CommitFlag::None);
+
+    expected.fill(Qt::red);
+    QTRY_VERIFY(img && *img == expected);
+    pwStream.stopStreaming();
+}
+
 }
 
 WAYLANDTEST_MAIN(KWin::ScreencastingTest)
@@ -48,6 +48,8 @@ private Q_SLOTS:
     void testKeepBelow();
 
     void testPreserveRelativeWindowStacking();
+
+    void benchmarkRaiseWithTransients();
 };
 
 void StackingOrderTest::initTestCase()
@@ -907,5 +909,64 @@ void StackingOrderTest::testPreserveRelativeWindowStacking()
     QCOMPARE(workspace()->stackingOrder(), (QList<Window *>{windows[0], windows[3], windows[4], windows[1], windows[2]}));
 }
 
+void StackingOrderTest::benchmarkRaiseWithTransients()
+{
+    // This test measures how long it takes to restack many windows with transients.
+
+    const int parentCount = 20;
+    const int transientCount = 4;
+
+    std::vector<std::unique_ptr<KWayland::Client::Surface>> surfaces;
+    std::vector<std::unique_ptr<Test::XdgToplevel>> shellSurfaces;
+    QList<Window *> parents;
+    QList<QList<Window *>> transients;
+
+    for (int i = 0; i < parentCount; ++i) {
+        std::unique_ptr<KWayland::Client::Surface> parentSurface = Test::createSurface();
+        QVERIFY(parentSurface);
+        std::unique_ptr<Test::XdgToplevel> parentShellSurface(Test::createXdgToplevelSurface(parentSurface.get(), parentSurface.get()));
+        QVERIFY(parentShellSurface);
+        Window *parent = Test::renderAndWaitForShown(parentSurface.get(), QSize(256, 256), Qt::blue);
+        QVERIFY(parent);
+
+        QList<Window *> children;
+        for (int j = 0; j < transientCount; ++j) {
+            std::unique_ptr<KWayland::Client::Surface> transientSurface = Test::createSurface();
+            QVERIFY(transientSurface);
+            std::unique_ptr<Test::XdgToplevel> transientShellSurface(Test::createXdgToplevelSurface(transientSurface.get(), transientSurface.get()));
+            QVERIFY(transientShellSurface);
+            transientShellSurface->set_parent(parentShellSurface->object());
+            Window *transient = Test::renderAndWaitForShown(transientSurface.get(), QSize(128, 128), Qt::red);
+            QVERIFY(transient);
+            QVERIFY(transient->isTransient());
+            children.append(transient);
+
+            surfaces.push_back(std::move(transientSurface));
+            shellSurfaces.push_back(std::move(transientShellSurface));
+        }
+
+        parents.append(parent);
+        transients.append(children);
+        surfaces.push_back(std::move(parentSurface));
+        shellSurfaces.push_back(std::move(parentShellSurface));
+    }
+
+    int round = 0;
+    QBENCHMARK {
+        workspace()->raiseWindow(parents[round % parentCount]);
+        ++round;
+    }
+
+    // The transients must still be above their parents.
+    const QList<Window *> stacking = workspace()->stackingOrder();
+    for (int i = 0; i < parentCount; ++i) {
+        const qsizetype parentIndex = stacking.indexOf(parents[i]);
+        QVERIFY(parentIndex != -1);
+        for (Window *transient : std::as_const(transients[i])) {
+            QVERIFY(stacking.indexOf(transient) > parentIndex);
+        }
+    }
+}
+
 WAYLANDTEST_MAIN(StackingOrderTest)
 #include "stacking_order_test.moc"
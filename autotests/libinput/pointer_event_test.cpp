@@ -40,6 +40,9 @@ private Q_SLOTS:
     void testScrollContinuous();
     void testMotion();
     void testAbsoluteMotion();
+    void testQueuedButton_data();
+    void testQueuedButton();
+    void testQueuedMotion();
 
 private:
     libinput_device *m_nativeDevice = nullptr;
@@ -270,6 +273,53 @@ void TestLibinputPointerEvent::testMotion()
     QCOMPARE(pe->delta(), QPointF(2.1, 4.5));
 }
 
+void TestLibinputPointerEvent::testQueuedButton_data()
+{
+    QTest::addColumn<libinput_button_state>("buttonState");
+    QTest::addColumn<bool>("expectedPressed");
+
+    QTest::newRow("released") << LIBINPUT_BUTTON_STATE_RELEASED << false;
+    QTest::newRow("pressed") << LIBINPUT_BUTTON_STATE_PRESSED << true;
+}
+
+void TestLibinputPointerEvent::testQueuedButton()
+{
+    // this test verifies that button events are decoded without creating an Event
+    libinput_event_pointer *pointerEvent = new libinput_event_pointer;
+    pointerEvent->device = m_nativeDevice;
+    pointerEvent->type = LIBINPUT_EVENT_POINTER_BUTTON;
+    QFETCH(libinput_button_state, buttonState);
+    pointerEvent->buttonState = buttonState;
+    pointerEvent->button = BTN_LEFT;
+    pointerEvent->time = 300ms;
+
+    const QueuedEvent queued = QueuedEvent::create(pointerEvent);
+    QCOMPARE(queued.type, LIBINPUT_EVENT_POINTER_BUTTON);
+    QCOMPARE(queued.nativeDevice, m_nativeDevice);
+    QCOMPARE(queued.time, 300ms);
+    QCOMPARE(queued.code, quint32(BTN_LEFT));
+    QTEST(queued.pressed, "expectedPressed");
+    QVERIFY(!queued.event);
+}
+
+void TestLibinputPointerEvent::testQueuedMotion()
+{
+    // this test verifies that motion events are decoded without creating an Event
+    libinput_event_pointer *pointerEvent = new libinput_event_pointer;
+    pointerEvent->device = m_nativeDevice;
+    pointerEvent->type = LIBINPUT_EVENT_POINTER_MOTION;
+    pointerEvent->delta = QPointF(2.1, 4.5);
+    pointerEvent->time = 500ms;
+
+    const QueuedEvent queued = QueuedEvent::create(pointerEvent);
+    QCOMPARE(queued.type, LIBINPUT_EVENT_POINTER_MOTION);
+    QCOMPARE(queued.nativeDevice, m_nativeDevice);
+    QCOMPARE(queued.time, 500ms);
+    QCOMPARE(queued.delta, QPointF(2.1, 4.5));
+    QCOMPARE(queued.deltaUnaccelerated, QPointF(2.1, 4.5));
+    QVERIFY(!queued.event);
+}
+
 void TestLibinputPointerEvent::testAbsoluteMotion()
 {
     // this test verifies absolute pointer motion
@@ -0,0 +1,178 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/damagejournal.h"
+
+#include <QTest>
+
+using namespace KWin;
+
+// The list based journal that DamageJournal replaces, used as a reference.
+class ReferenceDamageJournal
+{
+public:
+    void setCapacity(int capacity)
+    {
+        m_capacity = capacity;
+    }
+
+    void add(const QRegion &region)
+    {
+        while (m_log.size() >= m_capacity) {
+            m_log.takeLast();
+        }
+        m_log.prepend(region);
+    }
+
+    QRegion accumulate(int bufferAge, const QRegion &fallback = QRegion()) const
+    {
+        QRegion region;
+        if (bufferAge > 0 && bufferAge <= m_log.size()) {
+            for (int i = 0; i < bufferAge - 1; ++i) {
+                region |= m_log[i];
+            }
+        } else {
+            region = fallback;
+        }
+        return region;
+    }
+
+private:
+    QList<QRegion> m_log;
+    int m_capacity = 10;
+};
+
+class TestDamageJournal : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testAccumulate();
+    void testFallback();
+    void testClear();
+    void testSetCapacity();
+    void benchmarkAccumulate_data();
+    void benchmarkAccumulate();
+};
+
+static QRegion makeDamage(int frame)
+{
+    // Something resembling a blinking cursor plus a scrolling terminal line.
+    return QRegion(frame % 80 * 10, 0, 10, 20) + QRegion(0, (frame * 20) % 1000, 800, 20) + QRegion(frame % 7 * 100, 500, 50, 50);
+}
+
+void TestDamageJournal::testAccumulate()
+{
+    DamageJournal journal;
+    ReferenceDamageJournal reference;
+    journal.setCapacity(4);
+    reference.setCapacity(4);
+
+    for (int frame = 0; frame < 20; ++frame) {
+        journal.add(makeDamage(frame));
+        reference.add(makeDamage(frame));
+        QCOMPARE(journal.lastDamage(), makeDamage(frame));
+
+        // Query in a non-monotonic order to exercise the cached unions.
+        for (int age : {3, 1, 5, 2, 4, 0}) {
+            QCOMPARE(journal.accumulate(age, QRegion(0, 0, 1, 1)), reference.accumulate(age, QRegion(0, 0, 1, 1)));
+        }
+    }
+}
+
+void TestDamageJournal::testFallback()
+{
+    const QRegion fallback(0, 0, 1920, 1080);
+
+    DamageJournal journal;
+    QCOMPARE(journal.accumulate(1, fallback), fallback);
+
+    journal.add(QRegion(0, 0, 10, 10));
+    QCOMPARE(journal.accumulate(1, fallback), QRegion());
+    QCOMPARE(journal.accumulate(2, fallback), fallback);
+    QCOMPARE(journal.accumulate(0, fallback), fallback);
+    QCOMPARE(journal.accumulate(-1, fallback), fallback);
+}
+
+void TestDamageJournal::testClear()
+{
+    DamageJournal journal;
+    journal.add(QRegion(0, 0, 10, 10));
+    journal.add(QRegion(10, 10, 10, 10));
+    QCOMPARE(journal.accumulate(2), QRegion(10, 10, 10, 10));
+
+    journal.clear();
+    QCOMPARE(journal.accumulate(2, QRegion(0, 0, 1, 1)), QRegion(0, 0, 1, 1));
+
+    journal.add(QRegion(20, 20, 10, 10));
+    journal.add(QRegion(30, 30, 10, 10));
+    QCOMPARE(journal.accumulate(2), QRegion(30, 30, 10, 10));
+}
+
+void TestDamageJournal::testSetCapacity()
+{
+    DamageJournal journal;
+    ReferenceDamageJournal reference;
+    for (int frame = 0; frame < 10; ++frame) {
+        journal.add(makeDamage(frame));
+        reference.add(makeDamage(frame));
+    }
+
+    journal.setCapacity(3);
+    reference.setCapacity(3);
+    for (int age = 0; age <= 3; ++age) {
+        QCOMPARE(journal.accumulate(age), reference.accumulate(age));
+    }
+
+    for (int frame = 10; frame < 15; ++frame) {
+        journal.add(makeDamage(frame));
+        reference.add(makeDamage(frame));
+        for (int age = 0; age < 5; ++age) {
+            QCOMPARE(journal.accumulate(age), reference.accumulate(age));
+        }
+    }
+}
+
+void TestDamageJournal::benchmarkAccumulate_data()
+{
+    QTest::addColumn<bool>("reference");
+
+    QTest::addRow("reference") << true;
+    QTest::addRow("cached") << false;
+}
+
+void TestDamageJournal::benchmarkAccumulate()
+{
+    QFETCH(bool, reference);
+
+    // Every frame is accumulated for a few layers sharing the same journal, with triple buffering.
+    static const int layerCount = 4;
+    static const int bufferAge = 3;
+
+    int frame = 0;
+    if (reference) {
+        ReferenceDamageJournal journal;
+        QBENCHMARK {
+            journal.add(makeDamage(frame++));
+            for (int layer = 0; layer < layerCount; ++layer) {
+                journal.accumulate(bufferAge);
+            }
+        }
+    } else {
+        DamageJournal journal;
+        QBENCHMARK {
+            journal.add(makeDamage(frame++));
+            for (int layer = 0; layer < layerCount; ++layer) {
+                journal.accumulate(bufferAge);
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestDamageJournal)
+#include "test_damage_journal.moc"
@@ -0,0 +1,169 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "core/pixelgrid.h"
+#include "effect/globals.h"
+#include "scene/itemgeometry.h"
+
+#include <QTest>
+
+using namespace KWin;
+
+class TestDeviceClipRegion : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testClip_data();
+    void testClip();
+    void testContains();
+    void benchmarkClip_data();
+    void benchmarkClip();
+};
+
+static WindowQuad makeQuad(const QRectF &rect)
+{
+    WindowQuad quad;
+    quad[0] = WindowVertex(rect.topLeft(), QPointF(0, 0));
+    quad[1] = WindowVertex(rect.topRight(), QPointF(1, 0));
+    quad[2] = WindowVertex(rect.bottomRight(), QPointF(1, 1));
+    quad[3] = WindowVertex(rect.bottomLeft(), QPointF(0, 1));
+    return quad;
+}
+
+static WindowQuadList makeGrid(const QRectF &rect, int columns, int rows)
+{
+    WindowQuadList quads;
+    quads.append(makeQuad(rect));
+    return quads.makeRegularGrid(columns, rows);
+}
+
+static QRegion makeFragmentedRegion(const QRect &bounds, int columns, int rows)
+{
+    // A checkerboard of rects, similar to the damage of many small surfaces.
+    QRegion region;
+    const int width = bounds.width() / columns;
+    const int height = bounds.height() / rows;
+    for (int row = 0; row < rows; ++row) {
+        for (int column = row % 2; column < columns; column += 2) {
+            region += QRect(bounds.x() + column * width, bounds.y() + row * height, width, height);
+        }
+    }
+    return region;
+}
+
+// The scalar clipping loop that DeviceClipRegion replaces, used as a reference.
+static RenderGeometry referenceClip(const WindowQuadList &quads, const QRegion &clip, const QPointF &translation, qreal scale)
+{
+    RenderGeometry geometry;
+    for (const WindowQuad &quad : quads) {
+        const QRectF deviceBounds = snapToPixelGridF(scaledRect(quad.bounds(), scale));
+        for (const QRect &clipRect : clip) {
+            const QRectF deviceClipRect = snapToPixelGridF(scaledRect(clipRect, scale)).translated(-translation);
+            const QRectF intersected = deviceClipRect.intersected(deviceBounds);
+            if (intersected.isValid()) {
+                if (deviceBounds == intersected) {
+                    geometry.appendWindowQuad(quad, scale);
+                    break;
+                }
+                geometry.appendSubQuad(quad, intersected, scale);
+            }
+        }
+    }
+    return geometry;
+}
+
+static bool compareGeometry(const RenderGeometry &a, const RenderGeometry &b)
+{
+    if (a.count() != b.count()) {
+        return false;
+    }
+    for (int i = 0; i < a.count(); ++i) {
+        if (a[i].position != b[i].position || a[i].texcoord != b[i].texcoord) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TestDeviceClipRegion::testClip_data()
+{
+    QTest::addColumn<QRegion>("region");
+    QTest::addColumn<QPointF>("translation");
+    QTest::addColumn<qreal>("scale");
+
+    QTest::addRow("single rect") << QRegion(0, 0, 1920, 1080) << QPointF(100, 100) << 1.0;
+    QTest::addRow("partial") << QRegion(150, 150, 300, 200) << QPointF(100, 100) << 1.0;
+    QTest::addRow("fragmented") << makeFragmentedRegion(QRect(0, 0, 1920, 1080), 24, 16) << QPointF(100, 100) << 1.0;
+    QTest::addRow("fragmented fractional scale") << makeFragmentedRegion(QRect(0, 0, 1920, 1080), 24, 16) << QPointF(125, 125) << 1.25;
+    QTest::addRow("fragmented half scale") << makeFragmentedRegion(QRect(0, 0, 1920, 1080), 24, 16) << QPointF(50, 50) << 0.5;
+    // neighbour bands that are one pixel tall snap to the same device edges
+    QTest::addRow("thin bands half scale") << makeFragmentedRegion(QRect(0, 0, 1920, 64), 24, 64) << QPointF(50, 50) << 0.5;
+    QTest::addRow("empty") << QRegion() << QPointF(0, 0) << 1.0;
+}
+
+void TestDeviceClipRegion::testClip()
+{
+    QFETCH(QRegion, region);
+    QFETCH(QPointF, translation);
+    QFETCH(qreal, scale);
+
+    const WindowQuadList quads = makeGrid(QRectF(0, 0, 800, 600), 16, 16);
+
+    RenderGeometry geometry;
+    DeviceClipRegion(region, scale).clip(quads, translation, scale, geometry);
+
+    QVERIFY(compareGeometry(geometry, referenceClip(quads, region, translation, scale)));
+}
+
+void TestDeviceClipRegion::testContains()
+{
+    const DeviceClipRegion clip(QRegion(0, 0, 100, 100) + QRegion(200, 0, 100, 100), 1.0);
+    QVERIFY(!clip.isEmpty());
+
+    QVERIFY(clip.contains(QRectF(10, 10, 50, 50), QPointF(0, 0)));
+    QVERIFY(clip.contains(QRectF(10, 10, 50, 50), QPointF(200, 0)));
+    QVERIFY(!clip.contains(QRectF(10, 10, 50, 50), QPointF(100, 0)));
+    QVERIFY(!clip.contains(QRectF(0, 0, 300, 100), QPointF(0, 0)));
+
+    QVERIFY(DeviceClipRegion().isEmpty());
+    QVERIFY(!DeviceClipRegion().contains(QRectF(0, 0, 1, 1), QPointF(0, 0)));
+}
+
+void TestDeviceClipRegion::benchmarkClip_data()
+{
+    QTest::addColumn<bool>("reference");
+
+    QTest::addRow("reference") << true;
+    QTest::addRow("banded") << false;
+}
+
+void TestDeviceClipRegion::benchmarkClip()
+{
+    QFETCH(bool, reference);
+
+    // Roughly what a wobbling window over fragmented damage looks like.
+    const WindowQuadList quads = makeGrid(QRectF(0, 0, 1200, 900), 32, 32);
+    const QRegion region = makeFragmentedRegion(QRect(0, 0, 3840, 2160), 32, 24);
+    const QPointF translation(400, 300);
+    const qreal scale = 1.5;
+
+    if (reference) {
+        QBENCHMARK {
+            referenceClip(quads, region, translation, scale);
+        }
+    } else {
+        QBENCHMARK {
+            RenderGeometry geometry;
+            DeviceClipRegion(region, scale).clip(quads, translation, scale, geometry);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestDeviceClipRegion)
+#include "test_device_clip_region.moc"
@@ -0,0 +1,180 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "effect/globals.h"
+#include "scene/occlusionmap.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace KWin;
+
+class TestOcclusionMap : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEmpty();
+    void testContains();
+    void testSubtracted();
+    void testInfinite();
+    void testRandom();
+    void testClear();
+    void benchmarkCull_data();
+    void benchmarkCull();
+};
+
+static QRegion makeRoundedWindow(const QRect &rect, int radius)
+{
+    // The opaque region of a window with rounded corners, one rect per row in the corners.
+    QRegion region = rect.adjusted(0, radius, 0, -radius);
+    for (int i = 0; i < radius; ++i) {
+        const int inset = radius - std::sqrt(radius * radius - (radius - i) * (radius - i));
+        region += QRect(rect.x() + inset, rect.y() + i, rect.width() - 2 * inset, 1);
+        region += QRect(rect.x() + inset, rect.bottom() - i, rect.width() - 2 * inset, 1);
+    }
+    return region;
+}
+
+void TestOcclusionMap::testEmpty()
+{
+    OcclusionMap map;
+    QVERIFY(map.isEmpty());
+    QVERIFY(!map.contains(QRect(0, 0, 10, 10)));
+    QCOMPARE(map.subtracted(QRegion(0, 0, 10, 10)), QRegion(0, 0, 10, 10));
+}
+
+void TestOcclusionMap::testContains()
+{
+    OcclusionMap map(64);
+    map.add(QRegion(0, 0, 100, 100));
+    map.add(QRegion(100, 0, 100, 100));
+
+    QVERIFY(!map.isEmpty());
+    QVERIFY(map.contains(QRect(10, 10, 50, 50)));
+    // covered by two rects together, but by neither of them alone
+    QVERIFY(map.contains(QRect(50, 10, 100, 50)));
+    QVERIFY(!map.contains(QRect(150, 50, 100, 10)));
+    QVERIFY(!map.contains(QRect(-10, 0, 20, 20)));
+    QVERIFY(!map.contains(QRect(500, 500, 20, 20)));
+}
+
+void TestOcclusionMap::testSubtracted()
+{
+    OcclusionMap map(64);
+    map.add(QRegion(0, 0, 100, 100));
+
+    QCOMPARE(map.subtracted(QRegion(50, 50, 100, 100)), QRegion(50, 50, 100, 100) - QRegion(0, 0, 100, 100));
+    QCOMPARE(map.subtracted(QRegion(10, 10, 10, 10)), QRegion());
+    QCOMPARE(map.subtracted(QRegion(200, 200, 10, 10)), QRegion(200, 200, 10, 10));
+    QCOMPARE(map.subtracted(QRegion()), QRegion());
+}
+
+void TestOcclusionMap::testInfinite()
+{
+    // huge rects must neither be bucketed tile by tile nor be iterated tile by tile
+    OcclusionMap map(64);
+    map.add(QRegion(0, 0, 100, 100));
+    QCOMPARE(map.subtracted(infiniteRegion()), QRegion(infiniteRegion()) - QRegion(0, 0, 100, 100));
+    QVERIFY(!map.contains(infiniteRegion()));
+
+    map.add(QRegion(infiniteRegion()));
+    QVERIFY(map.contains(QRect(-5000, -5000, 10000, 10000)));
+    QCOMPARE(map.subtracted(QRegion(-5000, -5000, 10000, 10000)), QRegion());
+}
+
+void TestOcclusionMap::testRandom()
+{
+    QRandomGenerator generator(42);
+    auto randomRect = [&generator]() {
+        return QRect(generator.bounded(-200, 2000), generator.bounded(-200, 1200), generator.bounded(1, 800), generator.bounded(1, 600));
+    };
+
+    OcclusionMap map(128);
+    QRegion reference;
+    for (int i = 0; i < 50; ++i) {
+        const QRect window = randomRect();
+        const QRegion damage = QRegion(randomRect()) + randomRect();
+
+        QCOMPARE(map.subtracted(damage), damage - reference);
+        QCOMPARE(map.contains(window), (QRegion(window) - reference).isEmpty());
+
+        const QRegion opaque = makeRoundedWindow(window, std::min({8, window.width() / 2, window.height() / 2}));
+        map.add(opaque);
+        reference += opaque;
+    }
+}
+
+void TestOcclusionMap::testClear()
+{
+    OcclusionMap map(64);
+    map.add(QRegion(0, 0, 100, 100));
+    map.clear();
+    QVERIFY(map.isEmpty());
+    QVERIFY(!map.contains(QRect(10, 10, 10, 10)));
+    QCOMPARE(map.subtracted(QRegion(10, 10, 10, 10)), QRegion(10, 10, 10, 10));
+
+    // the window has moved, the tiles it used to cover must not be taken into account
+    map.add(QRegion(1000, 1000, 100, 100));
+    map.clear();
+    map.add(QRegion(2000, 0, 100, 100));
+    QVERIFY(!map.contains(QRect(1010, 1010, 10, 10)));
+    QVERIFY(map.contains(QRect(2010, 10, 10, 10)));
+    QCOMPARE(map.subtracted(QRegion(0, 0, 3000, 2000)), QRegion(0, 0, 3000, 2000) - QRegion(2000, 0, 100, 100));
+}
+
+void TestOcclusionMap::benchmarkCull_data()
+{
+    QTest::addColumn<bool>("useMap");
+
+    QTest::addRow("QRegion") << false;
+    QTest::addRow("OcclusionMap") << true;
+}
+
+void TestOcclusionMap::benchmarkCull()
+{
+    // 150 overlapping windows with rounded corners, culled from top to bottom
+    QFETCH(bool, useMap);
+
+    QRandomGenerator generator(7);
+    QList<QRect> windows;
+    QList<QRegion> opaque;
+    for (int i = 0; i < 150; ++i) {
+        const QRect window(generator.bounded(0, 3000), generator.bounded(0, 1600), generator.bounded(300, 900), generator.bounded(200, 600));
+        windows.append(window);
+        opaque.append(makeRoundedWindow(window, 12));
+    }
+    const QRegion damage(0, 0, 3840, 2160);
+
+    OcclusionMap map;
+    QBENCHMARK {
+        if (useMap) {
+            map.clear();
+            for (int i = windows.size() - 1; i >= 0; --i) {
+                if (!map.contains(windows[i])) {
+                    map.subtracted(damage & windows[i]);
+                }
+                map.add(opaque[i]);
+            }
+        } else {
+            QRegion visible = damage;
+            for (int i = windows.size() - 1; i >= 0; --i) {
+                const QRegion region = visible & windows[i];
+                Q_UNUSED(region)
+                visible -= opaque[i];
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestOcclusionMap)
+
+#include "test_occlusion_map.moc"
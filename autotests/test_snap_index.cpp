@@ -0,0 +1,115 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "snapindex.h"
+
+#include <QTest>
+
+using namespace KWin;
+
+class TestSnapIndex : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEmpty();
+    void testCandidates();
+    void testOrder();
+    void testUpdate();
+    void testRemove();
+    void testTransitive();
+};
+
+static Window *fakeWindow(quintptr id)
+{
+    // SnapIndex never dereferences the windows, so any distinct pointer will do.
+    return reinterpret_cast<Window *>(id * 16);
+}
+
+void TestSnapIndex::testEmpty()
+{
+    SnapIndex index;
+    QVERIFY(index.candidates({0, 100}, {0, 100}, 10).isEmpty());
+}
+
+void TestSnapIndex::testCandidates()
+{
+    SnapIndex index;
+    index.insert(fakeWindow(1), QRectF(0, 0, 100, 100));
+    index.insert(fakeWindow(2), QRectF(500, 500, 100, 100));
+    index.insert(fakeWindow(3), QRectF(105, 300, 50, 50));
+
+    // The right edge of the first window and the left edge of the third window are close.
+    QCOMPARE(index.candidates({110}, {}, 10), (QList<Window *>{fakeWindow(1), fakeWindow(3)}));
+    // The top edge of the second window.
+    QCOMPARE(index.candidates({}, {495}, 10), (QList<Window *>{fakeWindow(2)}));
+    // Nothing around.
+    QVERIFY(index.candidates({1000}, {1000}, 10).isEmpty());
+    // Every window is returned only once.
+    QCOMPARE(index.candidates({100, 105}, {100}, 10), (QList<Window *>{fakeWindow(1), fakeWindow(3)}));
+}
+
+void TestSnapIndex::testOrder()
+{
+    SnapIndex index;
+    index.insert(fakeWindow(3), QRectF(20, 0, 100, 100));
+    index.insert(fakeWindow(1), QRectF(10, 0, 100, 100));
+    index.insert(fakeWindow(2), QRectF(0, 0, 100, 100));
+
+    // The candidates are in the insertion order, not sorted by the edges.
+    QCOMPARE(index.candidates({10}, {}, 15), (QList<Window *>{fakeWindow(3), fakeWindow(1), fakeWindow(2)}));
+
+    // Updating the geometry doesn't change the order.
+    index.insert(fakeWindow(3), QRectF(5, 0, 100, 100));
+    QCOMPARE(index.candidates({10}, {}, 15), (QList<Window *>{fakeWindow(3), fakeWindow(1), fakeWindow(2)}));
+}
+
+void TestSnapIndex::testUpdate()
+{
+    SnapIndex index;
+    index.insert(fakeWindow(1), QRectF(0, 0, 100, 100));
+    QCOMPARE(index.candidates({100}, {}, 10), (QList<Window *>{fakeWindow(1)}));
+
+    index.insert(fakeWindow(1), QRectF(1000, 1000, 100, 100));
+    QVERIFY(index.candidates({100}, {}, 10).isEmpty());
+    QVERIFY(index.candidates({}, {100}, 10).isEmpty());
+    QCOMPARE(index.candidates({1100}, {}, 10), (QList<Window *>{fakeWindow(1)}));
+    QCOMPARE(index.candidates({}, {1000}, 10), (QList<Window *>{fakeWindow(1)}));
+}
+
+void TestSnapIndex::testRemove()
+{
+    SnapIndex index;
+    index.insert(fakeWindow(1), QRectF(0, 0, 100, 100));
+    index.insert(fakeWindow(2), QRectF(0, 0, 100, 100));
+    QVERIFY(index.contains(fakeWindow(1)));
+
+    index.remove(fakeWindow(1));
+    QVERIFY(!index.contains(fakeWindow(1)));
+    QCOMPARE(index.candidates({0}, {0}, 10), (QList<Window *>{fakeWindow(2)}));
+
+    // Removing an unknown window is harmless.
+    index.remove(fakeWindow(1));
+    QCOMPARE(index.candidates({0}, {0}, 10), (QList<Window *>{fakeWindow(2)}));
+}
+
+void TestSnapIndex::testTransitive()
+{
+    SnapIndex index;
+    index.insert(fakeWindow(1), QRectF(0, 0, 108, 100));
+    index.insert(fakeWindow(2), QRectF(0, 200, 116, 100));
+    index.insert(fakeWindow(3), QRectF(0, 400, 124, 100));
+
+    // Only the first window is close to the queried position, but an edge snapped to it
+    // could snap to the second window, and then to the third one.
+    QCOMPARE(index.candidates({100}, {}, 10), (QList<Window *>{fakeWindow(1)}));
+    QCOMPARE(index.candidates({100}, {}, 10, SnapIndex::Reach::Transitive), (QList<Window *>{fakeWindow(1), fakeWindow(2), fakeWindow(3)}));
+}
+
+QTEST_GUILESS_MAIN(TestSnapIndex)
+#include "test_snap_index.moc"
@@ -0,0 +1,154 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/spscqueue.h"
+
+#include <QTest>
+#include <QThread>
+
+#include <memory>
+
+using namespace KWin;
+
+class SpscQueueTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testCapacity();
+    void testPushPop();
+    void testFull();
+    void testWrapAround();
+    void testMoveOnly();
+    void testPopReleases();
+    void testThreads();
+};
+
+void SpscQueueTest::testCapacity()
+{
+    QCOMPARE(SpscQueue<int>(1).capacity(), size_t(1));
+    QCOMPARE(SpscQueue<int>(5).capacity(), size_t(8));
+    QCOMPARE(SpscQueue<int>(1024).capacity(), size_t(1024));
+}
+
+void SpscQueueTest::testPushPop()
+{
+    SpscQueue<int> queue(4);
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(queue.front(), nullptr);
+
+    QVERIFY(queue.push(1));
+    QVERIFY(queue.push(2));
+    QVERIFY(!queue.isEmpty());
+
+    QCOMPARE(*queue.front(), 1);
+    queue.pop();
+    QCOMPARE(*queue.front(), 2);
+    queue.pop();
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(queue.front(), nullptr);
+}
+
+void SpscQueueTest::testFull()
+{
+    SpscQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(!queue.isFull());
+        QVERIFY(queue.push(int(i)));
+    }
+    QVERIFY(queue.isFull());
+    QVERIFY(!queue.push(4));
+
+    queue.pop();
+    QVERIFY(!queue.isFull());
+    QVERIFY(queue.push(4));
+
+    for (int i = 1; i <= 4; ++i) {
+        QCOMPARE(*queue.front(), i);
+        queue.pop();
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void SpscQueueTest::testWrapAround()
+{
+    SpscQueue<int> queue(4);
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            QVERIFY(queue.push(int(next++)));
+        }
+        for (int i = 0; i < 3; ++i) {
+            QCOMPARE(*queue.front(), expected++);
+            queue.pop();
+        }
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void SpscQueueTest::testMoveOnly()
+{
+    SpscQueue<std::unique_ptr<int>> queue(2);
+    QVERIFY(queue.push(std::make_unique<int>(1)));
+    QCOMPARE(**queue.front(), 1);
+    queue.pop();
+    QVERIFY(queue.isEmpty());
+}
+
+void SpscQueueTest::testPopReleases()
+{
+    // popping must release the element instead of keeping it alive in the slot
+    SpscQueue<std::shared_ptr<int>> queue(2);
+    auto value = std::make_shared<int>(42);
+    const std::weak_ptr<int> weak = value;
+
+    QVERIFY(queue.push(std::move(value)));
+    QVERIFY(!weak.expired());
+    queue.pop();
+    QVERIFY(weak.expired());
+}
+
+void SpscQueueTest::testThreads()
+{
+    // the consumer must see every element exactly once and in order
+    constexpr int count = 1'000'000;
+    SpscQueue<int> queue(64);
+
+    std::unique_ptr<QThread> producer(QThread::create([&queue]() {
+        for (int i = 0; i < count;) {
+            if (queue.push(int(i))) {
+                ++i;
+            } else {
+                QThread::yieldCurrentThread();
+            }
+        }
+    }));
+    producer->start();
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        if (int *value = queue.front()) {
+            ordered &= *value == expected;
+            queue.pop();
+            ++expected;
+        } else {
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    producer->wait();
+    QVERIFY(ordered);
+    QVERIFY(queue.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(SpscQueueTest)
+
+#include "test_spsc_queue.moc"
@@ -0,0 +1,192 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+// Qt
+#include <QImage>
+#include <QSignalSpy>
+#include <QTest>
+#include <QThread>
+// KWin
+#include "wayland/compositor.h"
+#include "wayland/display.h"
+#include "wayland/surface.h"
+
+#include "KWayland/Client/compositor.h"
+#include "KWayland/Client/connection_thread.h"
+#include "KWayland/Client/event_queue.h"
+#include "KWayland/Client/registry.h"
+#include "KWayland/Client/shm_pool.h"
+#include "KWayland/Client/surface.h"
+
+// Wayland
+#include <wayland-client-protocol.h>
+
+// This test replaces malloc() and realloc() for the whole executable, so it must not be merged
+// into other tests.
+#if defined(__GLIBC__)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+
+// Only the allocations made by the thread that dispatches the Wayland requests are counted
+static thread_local bool s_countAllocations = false;
+static thread_local quint64 s_allocations = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    if (s_countAllocations) {
+        ++s_allocations;
+    }
+    return __libc_malloc(size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+    if (s_countAllocations) {
+        ++s_allocations;
+    }
+    return __libc_realloc(pointer, size);
+}
+#endif
+
+using namespace KWin;
+
+class TestWaylandSurfaceCommit : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void benchmarkCommit();
+
+private:
+    KWin::Display *m_display = nullptr;
+    KWin::CompositorInterface *m_compositorInterface = nullptr;
+    KWayland::Client::ConnectionThread *m_connection = nullptr;
+    KWayland::Client::Compositor *m_compositor = nullptr;
+    KWayland::Client::ShmPool *m_shm = nullptr;
+    KWayland::Client::EventQueue *m_queue = nullptr;
+    QThread *m_thread = nullptr;
+};
+
+static const QString s_socketName = QStringLiteral("kwin-test-wayland-surface-commit-0");
+
+void TestWaylandSurfaceCommit::init()
+{
+    m_display = new KWin::Display(this);
+    m_display->addSocketName(s_socketName);
+    m_display->start();
+    QVERIFY(m_display->isRunning());
+    m_display->createShm();
+
+    m_compositorInterface = new CompositorInterface(m_display, m_display);
+
+    // setup connection
+    m_connection = new KWayland::Client::ConnectionThread;
+    QSignalSpy connectedSpy(m_connection, &KWayland::Client::ConnectionThread::connected);
+    m_connection->setSocketName(s_socketName);
+
+    m_thread = new QThread(this);
+    m_connection->moveToThread(m_thread);
+    m_thread->start();
+
+    m_connection->initConnection();
+    QVERIFY(connectedSpy.wait());
+
+    m_queue = new KWayland::Client::EventQueue(this);
+    m_queue->setup(m_connection);
+    QVERIFY(m_queue->isValid());
+
+    KWayland::Client::Registry registry;
+    registry.setEventQueue(m_queue);
+    QSignalSpy compositorSpy(&registry, &KWayland::Client::Registry::compositorAnnounced);
+    QSignalSpy shmSpy(&registry, &KWayland::Client::Registry::shmAnnounced);
+    QSignalSpy allAnnounced(&registry, &KWayland::Client::Registry::interfacesAnnounced);
+    registry.create(m_connection->display());
+    QVERIFY(registry.isValid());
+    registry.setup();
+    QVERIFY(allAnnounced.wait());
+    QVERIFY(!compositorSpy.isEmpty());
+    QVERIFY(!shmSpy.isEmpty());
+
+    m_compositor = registry.createCompositor(compositorSpy.first().first().value<quint32>(), compositorSpy.first().last().value<quint32>(), this);
+    QVERIFY(m_compositor->isValid());
+    m_shm = registry.createShmPool(shmSpy.first().first().value<quint32>(), shmSpy.first().last().value<quint32>(), this);
+    QVERIFY(m_shm->isValid());
+}
+
+void TestWaylandSurfaceCommit::cleanup()
+{
+    delete m_compositor;
+    m_compositor = nullptr;
+    delete m_shm;
+    m_shm = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    delete m_connection;
+    m_connection = nullptr;
+
+    delete m_display;
+    m_display = nullptr;
+}
+
+void TestWaylandSurfaceCommit::benchmarkCommit()
+{
+#if !defined(__GLIBC__)
+    QSKIP("Counting allocations requires glibc");
+#else
+    // this benchmark measures how many memory allocations the compositor makes per surface commit
+    QSignalSpy serverSurfaceCreated(m_compositorInterface, &KWin::CompositorInterface::surfaceCreated);
+    std::unique_ptr<KWayland::Client::Surface> s(m_compositor->createSurface());
+    QVERIFY(serverSurfaceCreated.wait());
+    SurfaceInterface *serverSurface = serverSurfaceCreated.first().first().value<KWin::SurfaceInterface *>();
+    QVERIFY(serverSurface);
+
+    QImage black(100, 50, QImage::Format_RGB32);
+    black.fill(Qt::black);
+    QSharedPointer<KWayland::Client::Buffer> buffer = m_shm->createBuffer(black).toStrongRef();
+    QVERIFY(buffer);
+    QSignalSpy committedSpy(serverSurface, &SurfaceInterface::committed);
+    s->attachBuffer(buffer);
+    s->damage(QRect(0, 0, 100, 50));
+    s->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(committedSpy.wait());
+    QVERIFY(serverSurface->isMapped());
+
+    quint64 commits = 0;
+    QObject context;
+    connect(serverSurface, &SurfaceInterface::committed, &context, [&commits]() {
+        ++commits;
+    });
+
+    // the requests are dispatched manually so only the commits are measured
+    constexpr quint64 commitCount = 1000;
+    for (quint64 i = 0; i < commitCount; ++i) {
+        s->commit(KWayland::Client::Surface::CommitFlag::None);
+    }
+    wl_display_flush(m_connection->display());
+
+    s_allocations = 0;
+    while (commits < commitCount) {
+        s_countAllocations = true;
+        m_display->dispatchEvents();
+        s_countAllocations = false;
+    }
+    QCOMPARE(commits, commitCount);
+    QTest::setBenchmarkResult(qreal(s_allocations) / commits, QTest::Events);
+#endif
+}
+
+QTEST_GUILESS_MAIN(TestWaylandSurfaceCommit)
+#include "test_wayland_surface_commit.moc"
@@ -8,6 +8,7 @@
 #include <QTest>
 // WaylandServer
 #include "wayland/clientconnection.h"
+#include "wayland/clientconnection_p.h"
 #include "wayland/display.h"
 // Wayland
 #include <wayland-server.h>
@@ -27,6 +28,8 @@ private Q_SLOTS:
     void testClientConnection();
     void testConnectNoSocket();
     void testAutoSocketName();
+    void testClientStatistics();
+    void testRateCounter();
 };
 
 void TestWaylandServerDisplay::testSocketName()
@@ -179,5 +182,62 @@ void TestWaylandServerDisplay::testAutoSocketName()
     QCOMPARE(socketNameChangedSpy1.count(), 1);
 }
 
+void TestWaylandServerDisplay::testClientStatistics()
+{
+    KWin::Display display;
+    display.start();
+    QVERIFY(display.isRunning());
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) >= 0);
+    auto client = display.createClient(sv[0]);
+    QVERIFY(client);
+    QCOMPARE(client->requestCount(), quint64(0));
+    QCOMPARE(client->requestBytes(), quint64(0));
+
+    // send wl_display.sync and wl_display.get_registry, each request is 12 bytes long
+    const uint32_t requests[] = {
+        1, (12 << 16) | 0, 2,
+        1, (12 << 16) | 1, 3};
+    QCOMPARE(write(sv[1], requests, sizeof(requests)), ssize_t(sizeof(requests)));
+    display.dispatchEvents();
+
+    QCOMPARE(client->requestCount(), quint64(2));
+    QCOMPARE(client->requestBytes(), quint64(24));
+    QCOMPARE(client->requestsPerSecond(), 0u);
+    QCOMPARE(client->commitsPerSecond(), 0u);
+
+    wl_client_destroy(client->client());
+    close(sv[0]);
+    close(sv[1]);
+}
+
+void TestWaylandServerDisplay::testRateCounter()
+{
+    using namespace std::chrono_literals;
+    const std::chrono::steady_clock::time_point start(100s);
+
+    RateCounter counter;
+    counter.add(start);
+    counter.add(start + 100ms);
+    counter.add(start + 900ms);
+    // the first window is still running, there's no complete window yet
+    QCOMPARE(counter.rate(start + 950ms), 0u);
+    // the first window is over
+    QCOMPARE(counter.rate(start + 1500ms), 3u);
+
+    // starts the second window, the rate is the count of the first one until it's over
+    counter.add(start + 1200ms);
+    counter.add(start + 1300ms);
+    QCOMPARE(counter.rate(start + 1400ms), 3u);
+    QCOMPARE(counter.rate(start + 2300ms), 2u);
+
+    // nothing has happened for more than a whole window
+    QCOMPARE(counter.rate(start + 3300ms), 0u);
+    counter.add(start + 3300ms);
+    QCOMPARE(counter.rate(start + 3400ms), 0u);
+    QCOMPARE(counter.rate(start + 4400ms), 1u);
+}
+
 QTEST_GUILESS_MAIN(TestWaylandServerDisplay)
 #include "test_display.moc"
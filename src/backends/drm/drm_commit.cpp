@@ -158,6 +158,7 @@ bool DrmAtomicCommit::areBuffersReadable() const
 
 void DrmAtomicCommit::setDeadline(std::chrono::steady_clock::time_point deadline)
 {
+    m_deadline = deadline;
     for (const auto &[plane, buffer] : m_buffers) {
         if (buffer) {
             buffer->setDeadline(deadline);
@@ -165,6 +166,21 @@ void DrmAtomicCommit::setDeadline(std::chrono::steady_clock::time_point deadline
     }
 }
 
+std::chrono::steady_clock::time_point DrmAtomicCommit::deadline() const
+{
+    return m_deadline;
+}
+
+std::chrono::steady_clock::time_point DrmAtomicCommit::targetPageflipTime() const
+{
+    return m_targetPageflipTime;
+}
+
+void DrmAtomicCommit::setTargetPageflipTime(std::chrono::steady_clock::time_point targetTime)
+{
+    m_targetPageflipTime = targetTime;
+}
+
 std::optional<bool> DrmAtomicCommit::isVrr() const
 {
     return m_vrr;
@@ -194,6 +210,14 @@ void DrmAtomicCommit::merge(DrmAtomicCommit *onTop)
         m_vrr = onTop->m_vrr;
     }
     m_cursorOnly &= onTop->isCursorOnly();
+    // the merged commit has to be on time for the earliest of both
+    const auto earliest = [](std::chrono::steady_clock::time_point &own, std::chrono::steady_clock::time_point other) {
+        if (other != std::chrono::steady_clock::time_point{}) {
+            own = own == std::chrono::steady_clock::time_point{} ? other : std::min(own, other);
+        }
+    };
+    earliest(m_targetPageflipTime, onTop->m_targetPageflipTime);
+    earliest(m_deadline, onTop->m_deadline);
 }
 
 void DrmAtomicCommit::setCursorOnly(bool cursor)
@@ -72,7 +72,17 @@ public:
     void pageFlipped(std::chrono::nanoseconds timestamp) const override;
 
     bool areBuffersReadable() const;
+    /**
+     * The time by which this commit has to be submitted to the kernel to be
+     * presented at its target pageflip time.
+     */
+    std::chrono::steady_clock::time_point deadline() const;
     void setDeadline(std::chrono::steady_clock::time_point deadline);
+    /**
+     * The time at which this commit is supposed to be presented.
+     */
+    std::chrono::steady_clock::time_point targetPageflipTime() const;
+    void setTargetPageflipTime(std::chrono::steady_clock::time_point targetTime);
     std::optional<bool> isVrr() const;
     const std::unordered_set<DrmPlane *> &modifiedPlanes() const;
 
@@ -93,6 +103,8 @@ private:
     bool m_cursorOnly = false;
     bool m_modeset = false;
     PresentationMode m_mode = PresentationMode::VSync;
+    std::chrono::steady_clock::time_point m_targetPageflipTime;
+    std::chrono::steady_clock::time_point m_deadline;
 };
 
 class DrmLegacyCommit : public DrmCommit
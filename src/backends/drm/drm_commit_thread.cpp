@@ -10,6 +10,7 @@
 #include "drm_commit.h"
 #include "drm_gpu.h"
 #include "drm_logging.h"
+#include "utils/debugstatistics.h"
 #include "utils/realtime.h"
 
 using namespace std::chrono_literals;
@@ -17,11 +18,16 @@ using namespace std::chrono_literals;
 namespace KWin
 {
 
-// This value was chosen experimentally and should be adjusted if needed
-// committing takes about 800µs, the rest is accounting for sleep not being accurate enough
-static constexpr auto s_safetyMargin = 1800us;
+// Committing takes about 800µs on most hardware, the actual value is measured at runtime
+static constexpr auto s_initialCommitLatency = 800us;
+// Measurements above this are assumed to be outliers, e.g. caused by a modeset
+static constexpr auto s_maxCommitLatency = 5ms;
+// This value was chosen experimentally and should be adjusted if needed,
+// it accounts for sleep not being accurate enough
+static constexpr auto s_sleepSlack = 1ms;
 
 DrmCommitThread::DrmCommitThread(const QString &name)
+    : m_commitLatency(s_initialCommitLatency)
 {
     m_thread.reset(QThread::create([this]() {
         gainRealTime();
@@ -38,33 +44,37 @@ DrmCommitThread::DrmCommitThread(const QString &name)
                 continue;
             }
             if (!m_commits.empty()) {
-                const auto now = std::chrono::steady_clock::now();
-                if (m_targetPageflipTime > now + s_safetyMargin) {
+                const auto deadline = m_commits.front()->deadline();
+                if (deadline > std::chrono::steady_clock::now()) {
                     lock.unlock();
-                    std::this_thread::sleep_until(m_targetPageflipTime - s_safetyMargin);
+                    std::this_thread::sleep_until(deadline);
                     lock.lock();
                 }
                 optimizeCommits();
                 auto &commit = m_commits.front();
                 if (!commit->areBuffersReadable()) {
-                    // no commit is ready yet, reschedule
+                    // no commit is ready yet, reschedule it
                     if (m_vrr) {
-                        m_targetPageflipTime += 50us;
+                        scheduleCommit(commit.get(), commit->targetPageflipTime() + 50us);
                     } else {
-                        m_targetPageflipTime += m_minVblankInterval;
+                        scheduleCommit(commit.get(), commit->targetPageflipTime() + m_minVblankInterval);
                     }
                     continue;
                 }
                 const auto vrr = commit->isVrr();
+                const auto commitStart = std::chrono::steady_clock::now();
                 const bool success = commit->commit();
+                updateCommitLatency(std::chrono::steady_clock::now() - commitStart);
                 if (success) {
                     m_vrr = vrr.value_or(m_vrr);
+                    m_committedTargetPageflipTime = commit->targetPageflipTime();
                     m_committed = std::move(commit);
                     m_commits.erase(m_commits.begin());
                 } else {
                     const bool cursorOnly = std::all_of(m_commits.begin(), m_commits.end(), [](const auto &commit) {
                         return commit->isCursorOnly();
                     });
+                    m_droppedCommitCount += m_commits.size();
                     for (auto &commit : m_commits) {
                         m_droppedCommits.push_back(std::move(commit));
                     }
@@ -80,6 +90,9 @@ DrmCommitThread::DrmCommitThread(const QString &name)
     }));
     m_thread->setObjectName(name);
     m_thread->start();
+
+    setObjectName(QStringLiteral("DRM commits (%1)").arg(name));
+    DebugStatistics::self()->add(this);
 }
 
 void DrmCommitThread::optimizeCommits()
@@ -92,6 +105,7 @@ void DrmCommitThread::optimizeCommits()
         auto it = m_commits.begin() + 1;
         while (it != m_commits.end() && (*it)->areBuffersReadable()) {
             m_commits.front()->merge(it->get());
+            m_mergedCommitCount++;
             m_droppedCommits.push_back(std::move(*it));
             it = m_commits.erase(it);
         }
@@ -102,6 +116,7 @@ void DrmCommitThread::optimizeCommits()
         it++;
         while (it != m_commits.end() && commit->modifiedPlanes() == (*it)->modifiedPlanes() && (*it)->areBuffersReadable()) {
             commit->merge(it->get());
+            m_mergedCommitCount++;
             m_droppedCommits.push_back(std::move(*it));
             it = m_commits.erase(it);
         }
@@ -160,6 +175,7 @@ void DrmCommitThread::optimizeCommits()
         if (success) {
             if (front) {
                 front->merge(commit.get());
+                m_mergedCommitCount++;
                 m_droppedCommits.push_back(std::move(commit));
             } else {
                 front = std::move(commit);
@@ -187,17 +203,17 @@ void DrmCommitThread::addCommit(std::unique_ptr<DrmAtomicCommit> &&commit)
     m_commits.push_back(std::move(commit));
     const auto now = std::chrono::steady_clock::now();
     if (m_vrr && now >= m_lastPageflip + m_minVblankInterval) {
-        m_targetPageflipTime = now;
+        scheduleCommit(m_commits.back().get(), now);
     } else {
-        m_targetPageflipTime = estimateNextVblank(now);
+        scheduleCommit(m_commits.back().get(), estimateNextVblank(now));
     }
-    m_commits.back()->setDeadline(m_targetPageflipTime - s_safetyMargin);
     m_commitPending.notify_all();
 }
 
 void DrmCommitThread::setPendingCommit(std::unique_ptr<DrmLegacyCommit> &&commit)
 {
     m_committed = std::move(commit);
+    m_committedTargetPageflipTime.reset();
 }
 
 void DrmCommitThread::clearDroppedCommits()
@@ -216,9 +232,19 @@ void DrmCommitThread::pageFlipped(std::chrono::nanoseconds timestamp)
 {
     std::unique_lock lock(m_mutex);
     m_lastPageflip = TimePoint(timestamp);
+    if (m_committedTargetPageflipTime && m_lastPageflip > *m_committedTargetPageflipTime + m_minVblankInterval / 2) {
+        m_lateCommitCount++;
+    }
+    m_committedTargetPageflipTime.reset();
     m_committed.reset();
     if (!m_commits.empty()) {
-        m_targetPageflipTime = estimateNextVblank(std::chrono::steady_clock::now());
+        // commits that were supposed to be presented with this pageflip have to wait for the next one
+        const auto nextVblank = estimateNextVblank(std::chrono::steady_clock::now());
+        for (const auto &commit : m_commits) {
+            if (commit->targetPageflipTime() < nextVblank) {
+                scheduleCommit(commit.get(), nextVblank);
+            }
+        }
         m_commitPending.notify_all();
     }
 }
@@ -229,6 +255,50 @@ bool DrmCommitThread::pageflipsPending()
     return !m_commits.empty() || m_committed;
 }
 
+quint64 DrmCommitThread::droppedCommits() const
+{
+    return m_droppedCommitCount;
+}
+
+quint64 DrmCommitThread::mergedCommits() const
+{
+    return m_mergedCommitCount;
+}
+
+quint64 DrmCommitThread::lateCommits() const
+{
+    return m_lateCommitCount;
+}
+
+qint64 DrmCommitThread::commitLatency() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(m_commitLatency.load()).count();
+}
+
+std::chrono::nanoseconds DrmCommitThread::safetyMargin() const
+{
+    return m_commitLatency.load() + s_sleepSlack;
+}
+
+void DrmCommitThread::updateCommitLatency(std::chrono::nanoseconds latency)
+{
+    latency = std::min<std::chrono::nanoseconds>(latency, s_maxCommitLatency);
+    const auto current = m_commitLatency.load();
+    if (latency > current) {
+        // react to spikes immediately to avoid missing the next vblank
+        m_commitLatency = latency;
+    } else {
+        // but only slowly trust that commits have become faster again
+        m_commitLatency = current - (current - latency) / 16;
+    }
+}
+
+void DrmCommitThread::scheduleCommit(DrmAtomicCommit *commit, TimePoint targetPageflipTime)
+{
+    commit->setTargetPageflipTime(targetPageflipTime);
+    commit->setDeadline(targetPageflipTime - safetyMargin());
+}
+
 TimePoint DrmCommitThread::estimateNextVblank(TimePoint now) const
 {
     // the pageflip timestamp may be in the future
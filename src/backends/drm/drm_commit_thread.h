@@ -10,8 +10,10 @@
 
 #include <QObject>
 #include <QThread>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 namespace KWin
@@ -27,6 +29,23 @@ using TimePoint = std::chrono::steady_clock::time_point;
 class DrmCommitThread : public QObject
 {
     Q_OBJECT
+    /**
+     * The number of commits that were dropped because committing them failed.
+     */
+    Q_PROPERTY(quint64 droppedCommits READ droppedCommits)
+    /**
+     * The number of commits that were merged into another commit before being committed.
+     */
+    Q_PROPERTY(quint64 mergedCommits READ mergedCommits)
+    /**
+     * The number of commits that were presented after their target pageflip time.
+     */
+    Q_PROPERTY(quint64 lateCommits READ lateCommits)
+    /**
+     * The estimated time it takes the kernel to process an atomic commit, in microseconds.
+     */
+    Q_PROPERTY(qint64 commitLatency READ commitLatency)
+
 public:
     explicit DrmCommitThread(const QString &name);
     ~DrmCommitThread();
@@ -38,13 +57,21 @@ public:
     void pageFlipped(std::chrono::nanoseconds timestamp);
     bool pageflipsPending();
 
+    quint64 droppedCommits() const;
+    quint64 mergedCommits() const;
+    quint64 lateCommits() const;
+    qint64 commitLatency() const;
+
 Q_SIGNALS:
     void commitFailed();
 
 private:
     void clearDroppedCommits();
     TimePoint estimateNextVblank(TimePoint now) const;
+    std::chrono::nanoseconds safetyMargin() const;
+    void scheduleCommit(DrmAtomicCommit *commit, TimePoint targetPageflipTime);
     void optimizeCommits();
+    void updateCommitLatency(std::chrono::nanoseconds latency);
 
     std::unique_ptr<DrmCommit> m_committed;
     std::vector<std::unique_ptr<DrmAtomicCommit>> m_commits;
@@ -52,10 +79,15 @@ private:
     std::mutex m_mutex;
     std::condition_variable m_commitPending;
     TimePoint m_lastPageflip;
-    TimePoint m_targetPageflipTime;
     std::chrono::nanoseconds m_minVblankInterval;
     std::vector<std::unique_ptr<DrmAtomicCommit>> m_droppedCommits;
+    std::optional<TimePoint> m_committedTargetPageflipTime;
     bool m_vrr = false;
+
+    std::atomic<std::chrono::nanoseconds> m_commitLatency;
+    std::atomic<quint64> m_droppedCommitCount = 0;
+    std::atomic<quint64> m_mergedCommitCount = 0;
+    std::atomic<quint64> m_lateCommitCount = 0;
 };
 
 }
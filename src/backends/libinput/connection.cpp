@@ -38,6 +38,9 @@ namespace KWin
 namespace LibInput
 {
 
+// Enough to buffer a few frames worth of events from 8kHz devices
+static constexpr size_t s_eventQueueCapacity = 1024;
+
 class ConnectionAdaptor : public QObject
 {
     Q_OBJECT
@@ -101,6 +104,7 @@ std::unique_ptr<Connection> Connection::create(Session *session)
 
 Connection::Connection(std::unique_ptr<Context> &&input)
     : m_notifier(nullptr)
+    , m_eventQueue(s_eventQueueCapacity)
     , m_connectionAdaptor(std::make_unique<ConnectionAdaptor>(this))
     , m_input(std::move(input))
 {
@@ -150,17 +154,29 @@ void Connection::deactivate()
 
 void Connection::handleEvent()
 {
+    // libinput is not thread-safe, the main thread still calls into it for events that carry an Event
     QMutexLocker locker(&m_mutex);
-    const bool wasEmpty = m_eventQueue.empty();
+    // The notifier is disabled while the queue is full, resume listening once there is space again
+    m_notifier->setEnabled(!m_eventQueue.isFull());
+    bool notify = false;
     do {
+        if (m_eventQueue.isFull()) {
+            // Leave the remaining events in libinput, processEvents() will call us again. The socket
+            // stays readable until then, so stop listening to it instead of spinning on the notifier
+            m_notifier->setEnabled(false);
+            m_eventQueueFull = true;
+            notify = true;
+            break;
+        }
         m_input->dispatch();
-        std::unique_ptr<Event> event = m_input->event();
+        std::optional<QueuedEvent> event = m_input->event();
         if (!event) {
             break;
         }
-        m_eventQueue.push_back(std::move(event));
+        m_eventQueue.push(std::move(*event));
+        notify = true;
     } while (true);
-    if (wasEmpty && !m_eventQueue.empty()) {
+    if (notify && !m_eventsReadPending.exchange(true)) {
         Q_EMIT eventsRead();
     }
 }
@@ -262,11 +278,18 @@ static TabletPadId createTabletPadId(LibInput::Device *device)
 
 void Connection::processEvents()
 {
-    QMutexLocker locker(&m_mutex);
-    while (m_eventQueue.size() != 0) {
-        std::unique_ptr<Event> event = std::move(m_eventQueue.front());
-        m_eventQueue.pop_front();
-        switch (event->type()) {
+    // Reset before draining the queue so events pushed after the last pop trigger another call
+    m_eventsReadPending = false;
+
+    while (QueuedEvent *front = m_eventQueue.front()) {
+        // Decoded events don't touch libinput objects but the user data of their device, which is
+        // only accessed on this thread. Events that carry an Event call into libinput when they are
+        // handled and destroyed, so the lock must outlive the event.
+        QMutexLocker locker(front->event ? &m_mutex : nullptr);
+        QueuedEvent queued = std::move(*front);
+        m_eventQueue.pop();
+        const std::unique_ptr<Event> &event = queued.event;
+        switch (queued.type) {
         case LIBINPUT_EVENT_DEVICE_ADDED: {
             auto device = new Device(event->nativeDevice());
             device->moveToThread(thread());
@@ -301,8 +324,12 @@ void Connection::processEvents()
             break;
         }
         case LIBINPUT_EVENT_KEYBOARD_KEY: {
-            KeyEvent *ke = static_cast<KeyEvent *>(event.get());
-            Q_EMIT ke->device()->keyChanged(ke->key(), ke->state(), ke->time(), ke->device());
+            Device *device = Device::get(queued.nativeDevice);
+            if (!device) {
+                break;
+            }
+            const auto state = queued.pressed ? InputRedirection::KeyboardKeyPressed : InputRedirection::KeyboardKeyReleased;
+            Q_EMIT device->keyChanged(queued.code, state, queued.time, device);
             break;
         }
         case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL: {
@@ -348,30 +375,34 @@ void Connection::processEvents()
             break;
         }
         case LIBINPUT_EVENT_POINTER_BUTTON: {
-            PointerEvent *pe = static_cast<PointerEvent *>(event.get());
-            Q_EMIT pe->device()->pointerButtonChanged(pe->button(), pe->buttonState(), pe->time(), pe->device());
-            Q_EMIT pe->device()->pointerFrame(pe->device());
+            Device *device = Device::get(queued.nativeDevice);
+            if (!device) {
+                break;
+            }
+            const auto state = queued.pressed ? InputRedirection::PointerButtonPressed : InputRedirection::PointerButtonReleased;
+            Q_EMIT device->pointerButtonChanged(queued.code, state, queued.time, device);
+            Q_EMIT device->pointerFrame(device);
             break;
         }
         case LIBINPUT_EVENT_POINTER_MOTION: {
-            PointerEvent *pe = static_cast<PointerEvent *>(event.get());
-            auto delta = pe->delta();
-            auto deltaNonAccel = pe->deltaUnaccelerated();
-            auto latestTime = pe->time();
-            auto it = m_eventQueue.begin();
-            while (it != m_eventQueue.end()) {
-                if ((*it)->type() == LIBINPUT_EVENT_POINTER_MOTION) {
-                    std::unique_ptr<PointerEvent> p{static_cast<PointerEvent *>(it->release())};
-                    delta += p->delta();
-                    deltaNonAccel += p->deltaUnaccelerated();
-                    latestTime = p->time();
-                    it = m_eventQueue.erase(it);
-                } else {
+            Device *device = Device::get(queued.nativeDevice);
+            auto delta = queued.delta;
+            auto deltaNonAccel = queued.deltaUnaccelerated;
+            auto latestTime = queued.time;
+            while (QueuedEvent *next = m_eventQueue.front()) {
+                if (next->type != LIBINPUT_EVENT_POINTER_MOTION) {
                     break;
                 }
+                delta += next->delta;
+                deltaNonAccel += next->deltaUnaccelerated;
+                latestTime = next->time;
+                m_eventQueue.pop();
             }
-            Q_EMIT pe->device()->pointerMotion(delta, deltaNonAccel, latestTime, pe->device());
-            Q_EMIT pe->device()->pointerFrame(pe->device());
+            if (!device) {
+                break;
+            }
+            Q_EMIT device->pointerMotion(delta, deltaNonAccel, latestTime, device);
+            Q_EMIT device->pointerFrame(device);
             break;
         }
         case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE: {
@@ -570,6 +601,10 @@ void Connection::processEvents()
             break;
         }
     }
+
+    if (m_eventQueueFull.exchange(false)) {
+        QMetaObject::invokeMethod(this, &Connection::handleEvent, Qt::QueuedConnection);
+    }
 }
 
 void Connection::updateScreens()
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "effect/globals.h"
+#include "events.h"
+#include "utils/spscqueue.h"
 
 #include <KSharedConfig>
 
@@ -18,7 +20,7 @@
 #include <QRecursiveMutex>
 #include <QSize>
 #include <QStringList>
-#include <deque>
+#include <atomic>
 
 class QSocketNotifier;
 class QThread;
@@ -32,7 +34,6 @@ class Udev;
 namespace LibInput
 {
 
-class Event;
 class Device;
 class Context;
 class ConnectionAdaptor;
@@ -74,8 +75,12 @@ private:
     void applyScreenToDevice(Device *device);
     void doSetup();
     std::unique_ptr<QSocketNotifier> m_notifier;
+    // Serializes calls into libinput between the libinput thread and the main thread
     QRecursiveMutex m_mutex;
-    std::deque<std::unique_ptr<Event>> m_eventQueue;
+    // Filled by the libinput thread, drained by the main thread
+    SpscQueue<QueuedEvent> m_eventQueue;
+    std::atomic<bool> m_eventsReadPending = false;
+    std::atomic<bool> m_eventQueueFull = false;
     QList<Device *> m_devices;
     KSharedConfigPtr m_config;
     std::unique_ptr<ConnectionAdaptor> m_connectionAdaptor;
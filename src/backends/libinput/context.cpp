@@ -150,9 +150,13 @@ void Context::closeRestricted(int fd)
     m_session->closeRestricted(fd);
 }
 
-std::unique_ptr<Event> Context::event()
+std::optional<QueuedEvent> Context::event()
 {
-    return Event::create(libinput_get_event(m_libinput));
+    libinput_event *event = libinput_get_event(m_libinput);
+    if (!event) {
+        return std::nullopt;
+    }
+    return QueuedEvent::create(event);
 }
 
 void Context::suspend()
@@ -10,6 +10,7 @@
 
 #include <libinput.h>
 #include <memory>
+#include <optional>
 
 namespace KWin
 {
@@ -21,6 +22,7 @@ namespace LibInput
 {
 
 class Event;
+struct QueuedEvent;
 
 class Context
 {
@@ -55,7 +57,7 @@ public:
     /**
      * Gets the next event, if there is no new event @c nullptr is returned
      */
-    std::unique_ptr<Event> event();
+    std::optional<QueuedEvent> event();
 
     static int openRestrictedCallback(const char *path, int flags, void *user_data);
     static void closeRestrictedCallBack(int fd, void *user_data);
@@ -70,6 +70,43 @@ std::unique_ptr<Event> Event::create(libinput_event *event)
     }
 }
 
+QueuedEvent QueuedEvent::create(libinput_event *event)
+{
+    QueuedEvent queued;
+    queued.type = libinput_event_get_type(event);
+    queued.nativeDevice = libinput_event_get_device(event);
+    switch (queued.type) {
+    case LIBINPUT_EVENT_KEYBOARD_KEY: {
+        libinput_event_keyboard *keyboardEvent = libinput_event_get_keyboard_event(event);
+        queued.time = std::chrono::microseconds(libinput_event_keyboard_get_time_usec(keyboardEvent));
+        queued.code = libinput_event_keyboard_get_key(keyboardEvent);
+        queued.pressed = libinput_event_keyboard_get_key_state(keyboardEvent) == LIBINPUT_KEY_STATE_PRESSED;
+        libinput_event_destroy(event);
+        break;
+    }
+    case LIBINPUT_EVENT_POINTER_MOTION: {
+        libinput_event_pointer *pointerEvent = libinput_event_get_pointer_event(event);
+        queued.time = std::chrono::microseconds(libinput_event_pointer_get_time_usec(pointerEvent));
+        queued.delta = QPointF(libinput_event_pointer_get_dx(pointerEvent), libinput_event_pointer_get_dy(pointerEvent));
+        queued.deltaUnaccelerated = QPointF(libinput_event_pointer_get_dx_unaccelerated(pointerEvent), libinput_event_pointer_get_dy_unaccelerated(pointerEvent));
+        libinput_event_destroy(event);
+        break;
+    }
+    case LIBINPUT_EVENT_POINTER_BUTTON: {
+        libinput_event_pointer *pointerEvent = libinput_event_get_pointer_event(event);
+        queued.time = std::chrono::microseconds(libinput_event_pointer_get_time_usec(pointerEvent));
+        queued.code = libinput_event_pointer_get_button(pointerEvent);
+        queued.pressed = libinput_event_pointer_get_button_state(pointerEvent) == LIBINPUT_BUTTON_STATE_PRESSED;
+        libinput_event_destroy(event);
+        break;
+    }
+    default:
+        queued.event = Event::create(event);
+        break;
+    }
+    return queued;
+}
+
 Event::Event(libinput_event *event, libinput_event_type type)
     : m_event(event)
     , m_type(type)
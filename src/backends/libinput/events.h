@@ -48,6 +48,27 @@ private:
     mutable Device *m_device;
 };
 
+/**
+ * A libinput event as it's passed from the libinput thread to the main thread.
+ *
+ * The most frequent events, i.e. pointer motion, pointer button and key events, are decoded
+ * into plain values on the libinput thread so no Event has to be allocated for them. All
+ * other events are wrapped in an Event.
+ */
+struct QueuedEvent
+{
+    static QueuedEvent create(libinput_event *event);
+
+    libinput_event_type type = LIBINPUT_EVENT_NONE;
+    libinput_device *nativeDevice = nullptr;
+    std::chrono::microseconds time = std::chrono::microseconds::zero();
+    QPointF delta;
+    QPointF deltaUnaccelerated;
+    uint32_t code = 0;
+    bool pressed = false;
+    std::unique_ptr<Event> event;
+};
+
 class KeyEvent : public Event
 {
 public:
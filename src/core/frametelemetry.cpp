@@ -0,0 +1,151 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "core/frametelemetry.h"
+#include "utils/common.h"
+
+#include <QByteArray>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+
+namespace KWin
+{
+
+FrameTelemetry::FrameTelemetry()
+{
+    const int size = sizeof(Header) + sizeof(Record) * s_capacity;
+    const QByteArray initialContents(size, 0);
+    m_file = RamFile("kwin-frame-telemetry", initialContents.constData(), size, RamFile::Flag::Sealable);
+    if (!m_file.isValid()) {
+        return;
+    }
+
+    m_map = MemoryMap(size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file.fd(), 0);
+    if (!m_map.isValid()) {
+        qCWarning(KWIN_CORE) << "Failed to map frame telemetry buffer:" << strerror(errno);
+        return;
+    }
+
+    // Readers must not be able to resize or modify the buffer. The file is only handed out
+    // if that can be enforced, our own writable mapping must exist before it's sealed.
+#if HAVE_MEMFD && defined(F_SEAL_FUTURE_WRITE)
+    if (fcntl(m_file.fd(), F_ADD_SEALS, F_SEAL_FUTURE_WRITE | F_SEAL_SEAL) == 0) {
+        m_shareable = true;
+    } else {
+        qCWarning(KWIN_CORE) << "Failed to seal frame telemetry buffer:" << strerror(errno);
+    }
+#endif
+
+    m_header = static_cast<Header *>(m_map.data());
+    m_header->magic = s_magic;
+    m_header->version = s_version;
+    m_header->capacity = s_capacity;
+    m_header->recordSize = sizeof(Record);
+    m_header->head.store(0, std::memory_order_release);
+
+    m_records = reinterpret_cast<Record *>(static_cast<char *>(m_map.data()) + sizeof(Header));
+}
+
+int FrameTelemetry::fd() const
+{
+    return m_header && m_shareable ? m_file.fd() : -1;
+}
+
+void FrameTelemetry::beginFrame()
+{
+    m_pendingFrames.push_back(PendingFrame{});
+}
+
+void FrameTelemetry::addStageTime(Stage stage, std::chrono::nanoseconds duration)
+{
+    if (m_pendingFrames.empty()) {
+        return;
+    }
+
+    PendingFrame &frame = m_pendingFrames.back();
+    switch (stage) {
+    case Stage::PrePaint:
+        frame.timing.prePaintTime += duration.count();
+        break;
+    case Stage::Paint:
+        frame.timing.paintTime += duration.count();
+        break;
+    case Stage::PostPaint:
+        frame.timing.postPaintTime += duration.count();
+        break;
+    }
+    frame.lastStageEnd = std::chrono::steady_clock::now().time_since_epoch();
+}
+
+void FrameTelemetry::framePresented(std::chrono::nanoseconds timestamp, std::chrono::nanoseconds renderTime)
+{
+    if (m_pendingFrames.empty()) {
+        return;
+    }
+
+    PendingFrame frame = m_pendingFrames.front();
+    m_pendingFrames.pop_front();
+
+    frame.timing.presentationTimestamp = timestamp.count();
+    frame.timing.renderTime = renderTime.count();
+    if (frame.lastStageEnd != std::chrono::nanoseconds::zero() && timestamp > frame.lastStageEnd) {
+        frame.timing.presentationLatency = (timestamp - frame.lastStageEnd).count();
+    }
+
+    write(frame.timing);
+}
+
+void FrameTelemetry::frameFailed()
+{
+    if (!m_pendingFrames.empty()) {
+        m_pendingFrames.pop_front();
+    }
+}
+
+void FrameTelemetry::discardPendingFrames()
+{
+    m_pendingFrames.clear();
+}
+
+void FrameTelemetry::write(const FrameTiming &timing)
+{
+    if (!m_header) {
+        return;
+    }
+
+    const uint64_t head = m_header->head.load(std::memory_order_relaxed);
+    Record &record = m_records[head % s_capacity];
+
+    const uint64_t sequence = record.sequence.load(std::memory_order_relaxed);
+    record.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.timing = timing;
+    record.sequence.store(sequence + 2, std::memory_order_release);
+
+    m_header->head.store(head + 1, std::memory_order_release);
+}
+
+std::vector<FrameTiming> FrameTelemetry::timings() const
+{
+    if (!m_header) {
+        return {};
+    }
+
+    // The ring buffer is only written on the compositor thread, so no need to check sequences.
+    const uint64_t head = m_header->head.load(std::memory_order_acquire);
+    const uint64_t count = std::min<uint64_t>(head, s_capacity);
+
+    std::vector<FrameTiming> timings;
+    timings.reserve(count);
+    for (uint64_t i = head - count; i < head; ++i) {
+        timings.push_back(m_records[i % s_capacity].timing);
+    }
+    return timings;
+}
+
+} // namespace KWin
@@ -0,0 +1,121 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "utils/memorymap.h"
+#include "utils/ramfile.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+namespace KWin
+{
+
+/**
+ * The FrameTiming struct describes where the time of a single frame went.
+ *
+ * All durations and timestamps are in nanoseconds, the timestamps are sourced from the
+ * monotonic clock.
+ */
+struct FrameTiming
+{
+    int64_t presentationTimestamp = 0;
+    int64_t prePaintTime = 0;
+    int64_t paintTime = 0;
+    int64_t postPaintTime = 0;
+    int64_t renderTime = 0;
+    int64_t presentationLatency = 0;
+};
+
+/**
+ * The FrameTelemetry class records the timings of the frames presented on an output.
+ *
+ * The timings are stored in a ring buffer in shared memory, so external tools can map the
+ * file descriptor and read them without attaching a profiler. The compositor thread is the
+ * only writer. Every record carries a sequence number that is odd while the record is being
+ * written, readers should retry if the sequence number is odd or changed while reading.
+ */
+class KWIN_EXPORT FrameTelemetry
+{
+public:
+    enum class Stage {
+        PrePaint,
+        Paint,
+        PostPaint,
+    };
+
+    static constexpr uint32_t s_magic = 0x4b57464d; // "KWFM"
+    static constexpr uint32_t s_version = 1;
+    static constexpr uint32_t s_capacity = 1024;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t recordSize;
+        // The total number of records written so far, the newest one is at (head - 1) % capacity.
+        std::atomic<uint64_t> head;
+    };
+
+    struct Record
+    {
+        std::atomic<uint64_t> sequence;
+        FrameTiming timing;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    FrameTelemetry();
+
+    /**
+     * Returns the file descriptor of the shared memory that contains the ring buffer, or
+     * -1 if it could not be allocated or sealed against writes by readers.
+     */
+    int fd() const;
+
+    /**
+     * Starts tracking a new frame. Every frame must be finished with either framePresented()
+     * or frameFailed().
+     */
+    void beginFrame();
+    /**
+     * Adds @a duration to the time spent in the specified @a stage of the last started frame.
+     */
+    void addStageTime(Stage stage, std::chrono::nanoseconds duration);
+    void framePresented(std::chrono::nanoseconds timestamp, std::chrono::nanoseconds renderTime);
+    void frameFailed();
+    /**
+     * Forgets all frames that have been started but not finished yet.
+     */
+    void discardPendingFrames();
+
+    /**
+     * Returns the recorded frame timings, from the oldest to the newest one.
+     */
+    std::vector<FrameTiming> timings() const;
+
+private:
+    struct PendingFrame
+    {
+        FrameTiming timing;
+        std::chrono::nanoseconds lastStageEnd = std::chrono::nanoseconds::zero();
+    };
+
+    void write(const FrameTiming &timing);
+
+    RamFile m_file;
+    MemoryMap m_map;
+    Header *m_header = nullptr;
+    Record *m_records = nullptr;
+    bool m_shareable = false;
+    std::deque<PendingFrame> m_pendingFrames;
+};
+
+} // namespace KWin
@@ -6,6 +6,9 @@
 
 #include "renderjournal.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace KWin
 {
 
@@ -15,20 +18,27 @@ RenderJournal::RenderJournal()
 
 void RenderJournal::add(std::chrono::nanoseconds renderTime)
 {
-    if (renderTime > m_result || !m_lastAdd) {
-        m_result = renderTime;
-    } else {
-        static constexpr std::chrono::nanoseconds timeConstant = std::chrono::milliseconds(500);
-        const auto timeDifference = std::chrono::steady_clock::now() - *m_lastAdd;
-        const double ratio = std::min(0.1, double(timeDifference.count()) / double(timeConstant.count()));
-        m_result = std::chrono::nanoseconds(int64_t(renderTime.count() * ratio + m_result.count() * (1 - ratio)));
-    }
-    m_lastAdd = std::chrono::steady_clock::now();
+    m_log[m_head] = renderTime;
+    m_head = (m_head + 1) % s_capacity;
+    m_size = std::min(m_size + 1, s_capacity);
+    m_sortedDirty = true;
 }
 
-std::chrono::nanoseconds RenderJournal::result() const
+std::chrono::nanoseconds RenderJournal::result(qreal percentile) const
 {
-    return m_result;
+    if (!m_size) {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    if (m_sortedDirty) {
+        m_sorted.assign(m_log.begin(), m_log.begin() + m_size);
+        std::sort(m_sorted.begin(), m_sorted.end());
+        m_sortedDirty = false;
+    }
+
+    const qreal rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * m_size;
+    const int index = std::clamp(int(std::ceil(rank)) - 1, 0, m_size - 1);
+    return m_sorted[index];
 }
 
 } // namespace KWin
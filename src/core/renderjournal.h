@@ -11,12 +11,19 @@
 #include <QElapsedTimer>
 #include <QQueue>
 
+#include <array>
+#include <vector>
+
 namespace KWin
 {
 
 /**
  * The RenderJournal class measures how long it takes to render frames and estimates how
  * long it will take to render the next frame.
+ *
+ * The journal keeps a window of the most recent render times. The estimate is a percentile
+ * of the render times in that window, so a single slow frame neither raises the estimate for
+ * many frames nor gets ignored if it's part of a pattern.
  */
 class KWIN_EXPORT RenderJournal
 {
@@ -25,11 +32,21 @@ public:
 
     void add(std::chrono::nanoseconds renderTime);
 
-    std::chrono::nanoseconds result() const;
+    /**
+     * Returns the estimated render time for the next frame, which is the given @a percentile
+     * of the render times in the journal. A higher percentile trades latency for fewer
+     * missed frames.
+     */
+    std::chrono::nanoseconds result(qreal percentile = 99) const;
 
 private:
-    std::chrono::nanoseconds m_result{0};
-    std::optional<std::chrono::steady_clock::time_point> m_lastAdd;
+    static constexpr int s_capacity = 128;
+
+    std::array<std::chrono::nanoseconds, s_capacity> m_log;
+    int m_head = 0;
+    int m_size = 0;
+    mutable std::vector<std::chrono::nanoseconds> m_sorted;
+    mutable bool m_sortedDirty = false;
 };
 
 } // namespace KWin
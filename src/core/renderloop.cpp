@@ -60,7 +60,8 @@ void RenderLoopPrivate::scheduleRepaint()
     // - the buffer readiness deadline in the drm backend, which is 1.8ms before vblank
     // - scheduling and timer inaccuracies (estimated to be up to 1.2ms here)
     const std::chrono::nanoseconds safetyMargin = std::chrono::milliseconds(3);
-    std::chrono::nanoseconds nextRenderTimestamp = nextPresentationTimestamp - renderJournal.result() - safetyMargin;
+    const RenderJournal &renderJournal = renderJournals[int(frameClass)];
+    std::chrono::nanoseconds nextRenderTimestamp = nextPresentationTimestamp - renderJournal.result(options->renderTimePercentile()) - safetyMargin;
 
     // If we can't render the frame before the deadline, start compositing immediately.
     if (nextRenderTimestamp < currentTime) {
@@ -92,6 +93,8 @@ void RenderLoopPrivate::notifyFrameFailed()
 {
     Q_ASSERT(pendingFrameCount > 0);
     pendingFrameCount--;
+    pendingFrameClasses.pop_front();
+    telemetry.frameFailed();
 
     if (!inhibitCount) {
         maybeScheduleRepaint();
@@ -102,10 +105,13 @@ void RenderLoopPrivate::notifyFrameCompleted(std::chrono::nanoseconds timestamp,
 {
     Q_ASSERT(pendingFrameCount > 0);
     pendingFrameCount--;
+    const RenderLoop::FrameClass completedFrameClass = pendingFrameClasses.front();
+    pendingFrameClasses.pop_front();
 
     notifyVblank(timestamp);
 
-    renderJournal.add(renderTime);
+    renderJournals[int(completedFrameClass)].add(renderTime);
+    telemetry.framePresented(timestamp, renderTime);
     if (!inhibitCount) {
         maybeScheduleRepaint();
     }
@@ -143,6 +149,8 @@ void RenderLoopPrivate::invalidate()
 {
     pendingReschedule = false;
     pendingFrameCount = 0;
+    pendingFrameClasses.clear();
+    telemetry.discardPendingFrames();
     compositeTimer.stop();
 }
 
@@ -177,6 +185,9 @@ void RenderLoop::uninhibit()
 void RenderLoop::prepareNewFrame()
 {
     d->pendingFrameCount++;
+    // Frames that don't paint the scene, e.g. cursor updates, are cheap
+    d->pendingFrameClasses.push_back(FrameClass::Simple);
+    d->telemetry.beginFrame();
 }
 
 void RenderLoop::beginPaint()
@@ -240,6 +251,19 @@ void RenderLoop::setVrrPolicy(VrrPolicy policy)
     d->vrrPolicy = policy;
 }
 
+void RenderLoop::setFrameClass(FrameClass frameClass)
+{
+    d->frameClass = frameClass;
+    if (!d->pendingFrameClasses.empty()) {
+        d->pendingFrameClasses.back() = frameClass;
+    }
+}
+
+FrameTelemetry *RenderLoop::telemetry() const
+{
+    return &d->telemetry;
+}
+
 } // namespace KWin
 
 #include "moc_renderloop.cpp"
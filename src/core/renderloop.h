@@ -13,6 +13,7 @@
 namespace KWin
 {
 
+class FrameTelemetry;
 class RenderLoopPrivate;
 class Item;
 
@@ -109,6 +110,30 @@ public:
      */
     void setVrrPolicy(VrrPolicy vrrPolicy);
 
+    enum class FrameClass {
+        /**
+         * The screen is painted window by window without any transformations.
+         */
+        Simple,
+        /**
+         * The screen or some windows are transformed by effects.
+         */
+        Generic,
+    };
+    Q_ENUM(FrameClass)
+
+    /**
+     * Sets the class of the frame that is being rendered, i.e. the one started by the
+     * last prepareNewFrame(). Render times are tracked separately for every frame class,
+     * and the render time of the next frame is predicted from the frames of the same class.
+     */
+    void setFrameClass(FrameClass frameClass);
+
+    /**
+     * Returns the timings of the frames presented by this RenderLoop.
+     */
+    FrameTelemetry *telemetry() const;
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the refresh rate of this RenderLoop has changed.
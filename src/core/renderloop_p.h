@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include "frametelemetry.h"
 #include "renderjournal.h"
 #include "renderloop.h"
 
 #include <QTimer>
 
+#include <array>
+#include <deque>
 #include <optional>
 
 namespace KWin
@@ -37,9 +40,14 @@ public:
     std::chrono::nanoseconds lastPresentationTimestamp = std::chrono::nanoseconds::zero();
     std::chrono::nanoseconds nextPresentationTimestamp = std::chrono::nanoseconds::zero();
     QTimer compositeTimer;
-    RenderJournal renderJournal;
+    std::array<RenderJournal, 2> renderJournals;
+    // The class of the last painted frame, the next frame is expected to be alike
+    RenderLoop::FrameClass frameClass = RenderLoop::FrameClass::Simple;
+    FrameTelemetry telemetry;
     int refreshRate = 60000;
     int pendingFrameCount = 0;
+    // The classes of the pending frames, oldest first
+    std::deque<RenderLoop::FrameClass> pendingFrameClasses;
     int inhibitCount = 0;
     bool pendingReschedule = false;
     bool pendingRepaint = false;
@@ -15,14 +15,21 @@
 
 // kwin
 #include "compositor.h"
+#include "core/frametelemetry.h"
 #include "core/output.h"
+#include "core/outputbackend.h"
 #include "core/renderbackend.h"
+#include "core/renderloop.h"
 #include "debug_console.h"
 #include "kwinadaptor.h"
 #include "main.h"
+#include "options.h"
 #include "placement.h"
 #include "pluginmanager.h"
 #include "virtualdesktops.h"
+#include "wayland/clientconnection.h"
+#include "wayland/display.h"
+#include "wayland_server.h"
 #include "window.h"
 #include "workspace.h"
 #if KWIN_BUILD_ACTIVITIES
@@ -31,6 +38,7 @@
 
 // Qt
 #include <QDBusConnection>
+#include <QDBusUnixFileDescriptor>
 #include <QOpenGLContext>
 
 namespace KWin
@@ -217,6 +225,30 @@ QVariantMap DBusInterface::getWindowInfo(const QString &uuid)
     }
 }
 
+QVariantMap DBusInterface::clientStatistics()
+{
+    if (!waylandServer()) {
+        return {};
+    }
+
+    QVariantMap statistics;
+    const auto connections = waylandServer()->display()->connections();
+    for (ClientConnection *connection : connections) {
+        QString name = QStringLiteral("%1 (%2)").arg(connection->executablePath()).arg(connection->processId());
+        for (int i = 2; statistics.contains(name); ++i) {
+            name = QStringLiteral("%1 (%2) #%3").arg(connection->executablePath()).arg(connection->processId()).arg(i);
+        }
+        statistics.insert(name, QVariantMap{
+                                    {QStringLiteral("requestCount"), connection->requestCount()},
+                                    {QStringLiteral("requestBytes"), connection->requestBytes()},
+                                    {QStringLiteral("requestsPerSecond"), connection->requestsPerSecond()},
+                                    {QStringLiteral("commitsPerSecond"), connection->commitsPerSecond()},
+                                    {QStringLiteral("handlerTime"), connection->handlerTime()},
+                                });
+    }
+    return statistics;
+}
+
 void DBusInterface::showDesktop(bool show)
 {
     workspace()->setShowingDesktop(show, true);
@@ -313,11 +345,72 @@ bool CompositorDBusInterface::platformRequiresCompositing() const
     return kwinApp()->operationMode() != Application::OperationModeX11; // TODO: Remove this property?
 }
 
+double CompositorDBusInterface::renderTimePercentile() const
+{
+    return options->renderTimePercentile();
+}
+
+void CompositorDBusInterface::setRenderTimePercentile(double percentile)
+{
+    options->setRenderTimePercentile(percentile);
+}
+
 void CompositorDBusInterface::reinitialize()
 {
     m_compositor->reinitialize();
 }
 
+static FrameTelemetry *findFrameTelemetry(const QString &outputName)
+{
+    Output *output = kwinApp()->outputBackend()->findOutput(outputName);
+    if (!output || !output->renderLoop()) {
+        return nullptr;
+    }
+    return output->renderLoop()->telemetry();
+}
+
+QVariantMap CompositorDBusInterface::frameTimings(const QString &outputName) const
+{
+    const FrameTelemetry *telemetry = findFrameTelemetry(outputName);
+    if (!telemetry) {
+        return QVariantMap{};
+    }
+
+    const std::vector<FrameTiming> timings = telemetry->timings();
+    if (timings.empty()) {
+        return QVariantMap{{QStringLiteral("frames"), 0}};
+    }
+
+    QVariantMap summary{{QStringLiteral("frames"), qulonglong(timings.size())}};
+    const auto summarize = [&summary, &timings](const QString &name, int64_t FrameTiming::*field) {
+        std::vector<int64_t> values;
+        values.reserve(timings.size());
+        for (const FrameTiming &timing : timings) {
+            values.push_back(timing.*field);
+        }
+        std::sort(values.begin(), values.end());
+        summary.insert(name + QStringLiteral("P50"), qlonglong(values[(values.size() - 1) * 50 / 100]));
+        summary.insert(name + QStringLiteral("P99"), qlonglong(values[(values.size() - 1) * 99 / 100]));
+    };
+
+    summarize(QStringLiteral("prePaint"), &FrameTiming::prePaintTime);
+    summarize(QStringLiteral("paint"), &FrameTiming::paintTime);
+    summarize(QStringLiteral("postPaint"), &FrameTiming::postPaintTime);
+    summarize(QStringLiteral("render"), &FrameTiming::renderTime);
+    summarize(QStringLiteral("presentationLatency"), &FrameTiming::presentationLatency);
+
+    return summary;
+}
+
+QDBusUnixFileDescriptor CompositorDBusInterface::frameTelemetryFd(const QString &outputName) const
+{
+    const FrameTelemetry *telemetry = findFrameTelemetry(outputName);
+    if (!telemetry || telemetry->fd() == -1) {
+        return QDBusUnixFileDescriptor();
+    }
+    return QDBusUnixFileDescriptor(telemetry->fd());
+}
+
 QStringList CompositorDBusInterface::supportedOpenGLPlatformInterfaces() const
 {
     QStringList interfaces;
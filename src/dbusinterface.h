@@ -11,6 +11,7 @@
 
 #include <QDBusContext>
 #include <QDBusMessage>
+#include <QDBusUnixFileDescriptor>
 #include <QObject>
 
 #include "virtualdesktopsdbustypes.h"
@@ -89,6 +90,14 @@ public Q_SLOTS: // METHODS
      */
     QVariantMap getWindowInfo(const QString &uuid);
 
+    /**
+     * Returns a map with the request statistics of every connected Wayland client, such as the
+     * number of requests, the commit rate and the time spent handling the requests.
+     *
+     * The handler time is in microseconds.
+     */
+    QVariantMap clientStatistics();
+
     Q_NOREPLY void showDesktop(bool show);
 
 Q_SIGNALS:
@@ -150,6 +159,13 @@ class CompositorDBusInterface : public QObject
     Q_PROPERTY(QStringList supportedOpenGLPlatformInterfaces READ supportedOpenGLPlatformInterfaces)
 
     Q_PROPERTY(bool platformRequiresCompositing READ platformRequiresCompositing)
+
+    /**
+     * @brief The percentile of recent render times used to schedule compositing cycles.
+     *
+     * Lower values reduce latency at the risk of missing vblanks. Changes are not persisted.
+     */
+    Q_PROPERTY(double renderTimePercentile READ renderTimePercentile WRITE setRenderTimePercentile)
 public:
     explicit CompositorDBusInterface(Compositor *parent);
     ~CompositorDBusInterface() override = default;
@@ -161,6 +177,8 @@ public:
     QString compositingType() const;
     QStringList supportedOpenGLPlatformInterfaces() const;
     bool platformRequiresCompositing() const;
+    double renderTimePercentile() const;
+    void setRenderTimePercentile(double percentile);
 
 public Q_SLOTS:
     /**
@@ -170,6 +188,21 @@ public Q_SLOTS:
      */
     void reinitialize();
 
+    /**
+     * @brief Summarizes the timings of the recent frames presented on the given output.
+     *
+     * The returned map contains the number of frames and the 50th and 99th percentiles of
+     * every frame stage, in nanoseconds.
+     */
+    QVariantMap frameTimings(const QString &outputName) const;
+    /**
+     * @brief Returns a file descriptor of the shared memory with the frame timings of the
+     * given output.
+     *
+     * See FrameTelemetry for the memory layout.
+     */
+    QDBusUnixFileDescriptor frameTelemetryFd(const QString &outputName) const;
+
 Q_SIGNALS:
     void compositingToggled(bool active);
 
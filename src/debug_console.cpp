@@ -18,6 +18,7 @@
 #include "opengl/glplatform.h"
 #include "opengl/glutils.h"
 #include "platformsupport/scenes/opengl/openglbackend.h"
+#include "utils/debugstatistics.h"
 #include "utils/filedescriptor.h"
 #include "utils/subsurfacemonitor.h"
 #include "wayland/abstract_data_source.h"
@@ -48,6 +49,7 @@
 #include <QMouseEvent>
 #include <QScopeGuard>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 #include <QtConcurrentRun>
 
 #include <wayland-server-core.h>
@@ -608,6 +610,7 @@ DebugConsole::DebugConsole()
     m_ui->primaryContent->setModel(new DataSourceModel(this));
     m_ui->inputDevicesView->setModel(new InputDeviceModel(this));
     m_ui->inputDevicesView->setItemDelegate(new DebugConsoleDelegate(this));
+    m_ui->statisticsView->setModel(new StatisticsModel(this));
     m_ui->quitButton->setIcon(QIcon::fromTheme(QStringLiteral("application-exit")));
     m_ui->tabWidget->setTabIcon(0, QIcon::fromTheme(QStringLiteral("view-list-tree")));
     m_ui->tabWidget->setTabIcon(1, QIcon::fromTheme(QStringLiteral("view-list-tree")));
@@ -1578,6 +1581,114 @@ void InputDeviceModel::setupDeviceConnections(InputDevice *device)
     }
 }
 
+StatisticsModel::StatisticsModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_sources(DebugStatistics::self()->sources())
+    , m_refreshTimer(new QTimer(this))
+{
+    connect(DebugStatistics::self(), &DebugStatistics::sourceAdded, this, [this](QObject *source) {
+        beginInsertRows(QModelIndex(), m_sources.count(), m_sources.count());
+        m_sources << source;
+        endInsertRows();
+    });
+    connect(DebugStatistics::self(), &DebugStatistics::sourceRemoved, this, [this](QObject *source) {
+        const int index = m_sources.indexOf(source);
+        if (index == -1) {
+            return;
+        }
+        beginRemoveRows(QModelIndex(), index, index);
+        m_sources.removeAt(index);
+        endRemoveRows();
+    });
+
+    // The statistics are updated way too often to have notify signals, poll them instead.
+    m_refreshTimer->setInterval(std::chrono::seconds(1));
+    connect(m_refreshTimer, &QTimer::timeout, this, &StatisticsModel::refresh);
+    m_refreshTimer->start();
+}
+
+StatisticsModel::~StatisticsModel() = default;
+
+int StatisticsModel::columnCount(const QModelIndex &parent) const
+{
+    return 2;
+}
+
+QVariant StatisticsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (!index.parent().isValid()) {
+        if (index.column() == 0 && index.row() < m_sources.count()) {
+            return m_sources.at(index.row())->objectName();
+        }
+        return QVariant();
+    }
+
+    const QObject *source = m_sources.at(index.parent().row());
+    const QMetaProperty property = source->metaObject()->property(index.row() + QObject::staticMetaObject.propertyCount());
+    if (index.column() == 0) {
+        return property.name();
+    } else if (index.column() == 1) {
+        return property.read(source);
+    }
+    return QVariant();
+}
+
+QModelIndex StatisticsModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (column >= 2) {
+        return QModelIndex();
+    }
+    if (parent.isValid()) {
+        if (parent.internalId() & s_propertyBitMask) {
+            return QModelIndex();
+        }
+        if (row >= rowCount(parent)) {
+            return QModelIndex();
+        }
+        return createIndex(row, column, quint32(row + 1) << 16 | parent.internalId());
+    }
+    if (row >= m_sources.count()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, row + 1);
+}
+
+int StatisticsModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return m_sources.count();
+    }
+    if (parent.internalId() & s_propertyBitMask) {
+        return 0;
+    }
+
+    // Skip the properties inherited from QObject, i.e. objectName.
+    return m_sources.at(parent.row())->metaObject()->propertyCount() - QObject::staticMetaObject.propertyCount();
+}
+
+QModelIndex StatisticsModel::parent(const QModelIndex &child) const
+{
+    if (child.internalId() & s_propertyBitMask) {
+        const quintptr parentId = child.internalId() & s_windowBitMask;
+        return createIndex(parentId - 1, 0, parentId);
+    }
+    return QModelIndex();
+}
+
+void StatisticsModel::refresh()
+{
+    for (int i = 0; i < m_sources.count(); ++i) {
+        const QModelIndex parent = index(i, 0, QModelIndex());
+        const int count = rowCount(parent);
+        if (count > 0) {
+            Q_EMIT dataChanged(index(0, 1, parent), index(count - 1, 1, parent), QList<int>{Qt::DisplayRole});
+        }
+    }
+}
+
 QModelIndex DataSourceModel::index(int row, int column, const QModelIndex &parent) const
 {
     if (!m_source || parent.isValid() || column >= 2 || row >= m_source->mimeTypes().size()) {
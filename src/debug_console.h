@@ -20,6 +20,7 @@
 #include <memory>
 
 class QTextEdit;
+class QTimer;
 
 namespace Ui
 {
@@ -177,6 +178,26 @@ private:
     QList<InputDevice *> m_devices;
 };
 
+class StatisticsModel : public QAbstractItemModel
+{
+    Q_OBJECT
+public:
+    explicit StatisticsModel(QObject *parent = nullptr);
+    ~StatisticsModel() override;
+
+    int columnCount(const QModelIndex &parent) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QModelIndex index(int row, int column, const QModelIndex &parent) const override;
+    int rowCount(const QModelIndex &parent) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+
+private:
+    void refresh();
+
+    QList<QObject *> m_sources;
+    QTimer *m_refreshTimer;
+};
+
 class DataSourceModel : public QAbstractItemModel
 {
 public:
@@ -10,6 +10,7 @@
 
 #include "effect/animationeffect.h"
 #include "effect/anidata_p.h"
+#include "effect/animationtable_p.h"
 #include "effect/effecthandler.h"
 #include "opengl/glutils.h"
 
@@ -34,14 +35,14 @@ class AnimationEffectPrivate
 public:
     AnimationEffectPrivate()
     {
-        m_animationsTouched = m_isInitialized = false;
+        m_isInitialized = false;
         m_justEndedAnimation = 0;
     }
-    AnimationEffect::AniMap m_animations;
+    AnimationTable m_animations;
     static quint64 m_animCounter;
     quint64 m_justEndedAnimation; // protect against cancel
     std::weak_ptr<FullScreenEffectLock> m_fullScreenEffectLock;
-    bool m_needSceneRepaint, m_animationsTouched, m_isInitialized;
+    bool m_needSceneRepaint, m_isInitialized;
 };
 
 quint64 AnimationEffectPrivate::m_animCounter = 0;
@@ -221,11 +222,9 @@ quint64 AnimationEffect::p_animate(EffectWindow *w, Attribute a, uint meta, int
     if (!d->m_isInitialized) {
         init(); // needs to ensure the window gets removed if deleted in the same event cycle
     }
-    AniMap::iterator it = d->m_animations.find(w);
-    if (it == d->m_animations.end()) {
+    if (!d->m_animations.contains(w)) {
         connect(w, &EffectWindow::windowExpandedGeometryChanged,
                 this, &AnimationEffect::_windowExpandedGeometryChanged);
-        it = d->m_animations.insert(w, QPair<QList<AniData>, QRect>(QList<AniData>(), QRect()));
     }
 
     std::shared_ptr<FullScreenEffectLock> fullscreen;
@@ -241,7 +240,7 @@ quint64 AnimationEffect::p_animate(EffectWindow *w, Attribute a, uint meta, int
         CrossFadeEffect::redirect(w);
     }
 
-    it->first.append(AniData(
+    AniData animation(
         a, // Attribute
         meta, // Metadata
         to, // Target
@@ -250,10 +249,9 @@ quint64 AnimationEffect::p_animate(EffectWindow *w, Attribute a, uint meta, int
         waitAtSource, // Whether the animation should be kept at source
         fullscreen, // Full screen effect lock
         keepAlive, // Keep alive flag
-        shader));
+        shader);
 
     const quint64 ret_id = ++d->m_animCounter;
-    AniData &animation = it->first.last();
     animation.id = ret_id;
 
     animation.visibleRef = EffectWindowVisibleRef(w, EffectWindow::PAINT_DISABLED_BY_MINIMIZE | EffectWindow::PAINT_DISABLED_BY_DESKTOP | EffectWindow::PAINT_DISABLED);
@@ -268,9 +266,8 @@ quint64 AnimationEffect::p_animate(EffectWindow *w, Attribute a, uint meta, int
         animation.terminationFlags |= TerminateAtTarget;
     }
 
-    it->second = QRect();
-
-    d->m_animationsTouched = true;
+    AnimationTable::Entry &entry = d->m_animations.add(w, std::move(animation));
+    entry.layerRect = QRect();
 
     if (delay > 0) {
         QTimer::singleShot(delay, this, &AnimationEffect::triggerRepaint);
@@ -293,29 +290,24 @@ bool AnimationEffect::retarget(quint64 animationId, FPx2 newTarget, int newRemai
     if (animationId == d->m_justEndedAnimation) {
         return false; // this is just ending, do not try to retarget it
     }
-    for (AniMap::iterator entry = d->m_animations.begin(),
-                          mapEnd = d->m_animations.end();
-         entry != mapEnd; ++entry) {
-        for (QList<AniData>::iterator anim = entry->first.begin(),
-                                      animEnd = entry->first.end();
-             anim != animEnd; ++anim) {
-            if (anim->id == animationId) {
-                anim->from.set(interpolated(*anim, 0), interpolated(*anim, 1));
-                validate(anim->attribute, anim->meta, nullptr, &newTarget, entry.key());
-                anim->to.set(newTarget[0], newTarget[1]);
-
-                anim->timeLine.setDirection(TimeLine::Forward);
-                anim->timeLine.setDuration(std::chrono::milliseconds(newRemainingTime));
-                anim->timeLine.reset();
-
-                if (anim->attribute == CrossFadePrevious) {
-                    CrossFadeEffect::redirect(entry.key());
-                }
-                return true;
-            }
-        }
+    AnimationTable::Entry *entry;
+    AniData *anim = d->m_animations.animation(animationId, &entry);
+    if (!anim) {
+        return false; // no animation found
+    }
+
+    anim->from.set(interpolated(*anim, 0), interpolated(*anim, 1));
+    validate(anim->attribute, anim->meta, nullptr, &newTarget, entry->window);
+    anim->to.set(newTarget[0], newTarget[1]);
+
+    anim->timeLine.setDirection(TimeLine::Forward);
+    anim->timeLine.setDuration(std::chrono::milliseconds(newRemainingTime));
+    anim->timeLine.reset();
+
+    if (anim->attribute == CrossFadePrevious) {
+        CrossFadeEffect::redirect(entry->window);
     }
-    return false; // no animation found
+    return true;
 }
 
 bool AnimationEffect::freezeInTime(quint64 animationId, qint64 frozenTime)
@@ -325,22 +317,16 @@ bool AnimationEffect::freezeInTime(quint64 animationId, qint64 frozenTime)
     if (animationId == d->m_justEndedAnimation) {
         return false; // this is just ending, do not try to retarget it
     }
-    for (AniMap::iterator entry = d->m_animations.begin(),
-                          mapEnd = d->m_animations.end();
-         entry != mapEnd; ++entry) {
-        for (QList<AniData>::iterator anim = entry->first.begin(),
-                                      animEnd = entry->first.end();
-             anim != animEnd; ++anim) {
-            if (anim->id == animationId) {
-                if (frozenTime >= 0) {
-                    anim->timeLine.setElapsed(std::chrono::milliseconds(frozenTime));
-                }
-                anim->frozenTime = frozenTime;
-                return true;
-            }
-        }
+    AniData *anim = d->m_animations.animation(animationId);
+    if (!anim) {
+        return false; // no animation found
+    }
+
+    if (frozenTime >= 0) {
+        anim->timeLine.setElapsed(std::chrono::milliseconds(frozenTime));
     }
-    return false; // no animation found
+    anim->frozenTime = frozenTime;
+    return true;
 }
 
 bool AnimationEffect::redirect(quint64 animationId, Direction direction, TerminationFlags terminationFlags)
@@ -350,31 +336,24 @@ bool AnimationEffect::redirect(quint64 animationId, Direction direction, Termina
         return false;
     }
 
-    for (auto entryIt = d->m_animations.begin(); entryIt != d->m_animations.end(); ++entryIt) {
-        auto animIt = std::find_if(entryIt->first.begin(), entryIt->first.end(),
-                                   [animationId](AniData &anim) {
-                                       return anim.id == animationId;
-                                   });
-        if (animIt == entryIt->first.end()) {
-            continue;
-        }
-
-        switch (direction) {
-        case Backward:
-            animIt->timeLine.setDirection(TimeLine::Backward);
-            break;
-
-        case Forward:
-            animIt->timeLine.setDirection(TimeLine::Forward);
-            break;
-        }
+    AniData *anim = d->m_animations.animation(animationId);
+    if (!anim) {
+        return false;
+    }
 
-        animIt->terminationFlags = terminationFlags & ~TerminateAtTarget;
+    switch (direction) {
+    case Backward:
+        anim->timeLine.setDirection(TimeLine::Backward);
+        break;
 
-        return true;
+    case Forward:
+        anim->timeLine.setDirection(TimeLine::Forward);
+        break;
     }
 
-    return false;
+    anim->terminationFlags = terminationFlags & ~TerminateAtTarget;
+
+    return true;
 }
 
 bool AnimationEffect::complete(quint64 animationId)
@@ -385,22 +364,16 @@ bool AnimationEffect::complete(quint64 animationId)
         return false;
     }
 
-    for (auto entryIt = d->m_animations.begin(); entryIt != d->m_animations.end(); ++entryIt) {
-        auto animIt = std::find_if(entryIt->first.begin(), entryIt->first.end(),
-                                   [animationId](AniData &anim) {
-                                       return anim.id == animationId;
-                                   });
-        if (animIt == entryIt->first.end()) {
-            continue;
-        }
-
-        animIt->timeLine.setElapsed(animIt->timeLine.duration());
-        unredirect(entryIt.key());
-
-        return true;
+    AnimationTable::Entry *entry;
+    AniData *anim = d->m_animations.animation(animationId, &entry);
+    if (!anim) {
+        return false;
     }
 
-    return false;
+    anim->timeLine.setElapsed(anim->timeLine.duration());
+    unredirect(entry->window);
+
+    return true;
 }
 
 bool AnimationEffect::cancel(quint64 animationId)
@@ -409,27 +382,26 @@ bool AnimationEffect::cancel(quint64 animationId)
     if (animationId == d->m_justEndedAnimation) {
         return true; // this is just ending, do not try to cancel it but fake success
     }
-    for (AniMap::iterator entry = d->m_animations.begin(), mapEnd = d->m_animations.end(); entry != mapEnd; ++entry) {
-        for (QList<AniData>::iterator anim = entry->first.begin(), animEnd = entry->first.end(); anim != animEnd; ++anim) {
-            if (anim->id == animationId) {
-                EffectWindowDeletedRef ref = std::move(anim->deletedRef); // delete window once we're done updating m_animations
-                if (anim->shader && std::none_of(entry->first.begin(), entry->first.end(), [animationId](const auto &anim) {
-                        return anim.id != animationId && anim.shader;
-                    })) {
-                    unredirect(entry.key());
-                }
-                entry->first.erase(anim); // remove the animation
-                if (entry->first.isEmpty()) { // no other animations on the window, release it.
-                    disconnect(entry.key(), &EffectWindow::windowExpandedGeometryChanged,
-                               this, &AnimationEffect::_windowExpandedGeometryChanged);
-                    d->m_animations.erase(entry);
-                }
-                d->m_animationsTouched = true; // could be called from animationEnded
-                return true;
-            }
-        }
+    AnimationTable::Entry *entry;
+    AniData *anim = d->m_animations.animation(animationId, &entry);
+    if (!anim) {
+        return false;
+    }
+
+    EffectWindowDeletedRef ref = std::move(anim->deletedRef); // delete window once we're done updating m_animations
+    EffectWindow *window = entry->window;
+    if (anim->shader && std::none_of(entry->animations.cbegin(), entry->animations.cend(), [animationId](const auto &anim) {
+            return anim.id != animationId && anim.shader;
+        })) {
+        unredirect(window);
     }
-    return false;
+    d->m_animations.remove(animationId); // remove the animation
+    if (entry->animations.isEmpty()) { // no other animations on the window, release it.
+        disconnect(window, &EffectWindow::windowExpandedGeometryChanged,
+                   this, &AnimationEffect::_windowExpandedGeometryChanged);
+        d->m_animations.remove(window);
+    }
+    return true;
 }
 
 void AnimationEffect::animationEnded(EffectWindow *w, Attribute a, uint meta)
@@ -486,20 +458,17 @@ QRect AnimationEffect::clipRect(const QRect &geo, const AniData &anim) const
 void AnimationEffect::prePaintWindow(EffectWindow *w, WindowPrePaintData &data, std::chrono::milliseconds presentTime)
 {
     Q_D(AnimationEffect);
-    auto entry = d->m_animations.find(w);
-    if (entry != d->m_animations.end()) {
-        for (auto anim = entry->first.begin(); anim != entry->first.end(); ++anim) {
-            if (anim->startTime > clock() && !anim->waitAtSource) {
+    if (AnimationTable::Entry *entry = d->m_animations.find(w)) {
+        const qint64 now = clock();
+        AnimationTable::advance(*entry, presentTime, now);
+        for (const AniData &anim : entry->animations) {
+            if (anim.startTime > now && !anim.waitAtSource) {
                 continue;
             }
 
-            if (anim->frozenTime < 0) {
-                anim->timeLine.advance(presentTime);
-            }
-
-            if (anim->attribute == Opacity || anim->attribute == CrossFadePrevious) {
+            if (anim.attribute == Opacity || anim.attribute == CrossFadePrevious) {
                 data.setTranslucent();
-            } else if (!(anim->attribute == Brightness || anim->attribute == Saturation)) {
+            } else if (!(anim.attribute == Brightness || anim.attribute == Saturation)) {
                 data.setTransformed();
             }
         }
@@ -521,13 +490,14 @@ static inline float geometryCompensation(int flags, float v)
 void AnimationEffect::paintWindow(const RenderTarget &renderTarget, const RenderViewport &viewport, EffectWindow *w, int mask, QRegion region, WindowPaintData &data)
 {
     Q_D(AnimationEffect);
-    AniMap::const_iterator entry = d->m_animations.constFind(w);
+    const AnimationTable::Entry *entry = d->m_animations.find(w);
     auto finalRegion = region;
 
-    if (entry != d->m_animations.constEnd()) {
-        for (QList<AniData>::const_iterator anim = entry->first.constBegin(); anim != entry->first.constEnd(); ++anim) {
+    if (entry) {
+        const qint64 now = clock();
+        for (auto anim = entry->animations.cbegin(); anim != entry->animations.cend(); ++anim) {
 
-            if (anim->startTime > clock() && !anim->waitAtSource) {
+            if (anim->startTime > now && !anim->waitAtSource) {
                 continue;
             }
 
@@ -651,64 +621,49 @@ void AnimationEffect::paintWindow(const RenderTarget &renderTarget, const Render
 void AnimationEffect::postPaintScreen()
 {
     Q_D(AnimationEffect);
-    d->m_animationsTouched = false;
     bool damageDirty = false;
     std::vector<EffectWindowDeletedRef> zombies;
 
-    for (auto entry = d->m_animations.begin(); entry != d->m_animations.end();) {
-        bool invalidateLayerRect = false;
-        int animCounter = 0;
-        for (auto anim = entry->first.begin(); anim != entry->first.end();) {
-            if (anim->isActive() || (anim->startTime > clock() && !anim->waitAtSource)) {
-                ++anim;
-                ++animCounter;
-                continue;
-            }
-            EffectWindow *window = entry.key();
-            d->m_justEndedAnimation = anim->id;
-            if (anim->shader && std::none_of(entry->first.begin(), entry->first.end(), [anim](const auto &other) {
-                    return anim->id != other.id && other.shader;
-                })) {
-                unredirect(window);
-            }
+    // animationEnded() may start or cancel animations, so the table is not walked while the
+    // ended animations are removed, they are looked up by their ids instead
+    const QList<quint64> finished = d->m_animations.finished(clock());
+    for (const quint64 id : finished) {
+        AnimationTable::Entry *entry;
+        AniData *anim = d->m_animations.animation(id, &entry);
+        if (!anim || anim->isActive()) {
+            continue; // cancelled or restarted by a previous animationEnded()
+        }
+        EffectWindow *window = entry->window;
+        d->m_justEndedAnimation = id;
+        if (anim->shader && std::none_of(entry->animations.cbegin(), entry->animations.cend(), [id](const auto &other) {
+                return id != other.id && other.shader;
+            })) {
             unredirect(window);
-            animationEnded(window, anim->attribute, anim->meta);
-            d->m_justEndedAnimation = 0;
-            // NOTICE animationEnded is an external call and might have called "::animate"
-            // as a result our iterators could now point random junk on the heap
-            // so we've to restore the former states, ie. find our window list and animation
-            if (d->m_animationsTouched) {
-                d->m_animationsTouched = false;
-                entry = d->m_animations.begin();
-                while (entry.key() != window && entry != d->m_animations.end()) {
-                    ++entry;
-                }
-                Q_ASSERT(entry != d->m_animations.end()); // usercode should not delete animations from animationEnded (not even possible atm.)
-                anim = entry->first.begin();
-                Q_ASSERT(animCounter < entry->first.count());
-                for (int i = 0; i < animCounter; ++i) {
-                    ++anim;
-                }
-            }
-            // If it's a closed window, keep it alive for a little bit longer until we're done
-            // updating m_animations. Otherwise our windowDeleted slot can access m_animations
-            // while we still modify it.
-            if (!anim->deletedRef.isNull()) {
-                zombies.emplace_back(std::move(anim->deletedRef));
-            }
-            anim = entry->first.erase(anim);
-            invalidateLayerRect = damageDirty = true;
         }
-        if (entry->first.isEmpty()) {
-            disconnect(entry.key(), &EffectWindow::windowExpandedGeometryChanged,
+        unredirect(window);
+        const Attribute attribute = anim->attribute;
+        const uint meta = anim->meta;
+        animationEnded(window, attribute, meta);
+        d->m_justEndedAnimation = 0;
+
+        anim = d->m_animations.animation(id, &entry);
+        Q_ASSERT(anim); // usercode should not delete animations from animationEnded (not even possible atm.)
+        // If it's a closed window, keep it alive for a little bit longer until we're done
+        // updating m_animations. Otherwise our windowDeleted slot can access m_animations
+        // while we still modify it.
+        if (!anim->deletedRef.isNull()) {
+            zombies.emplace_back(std::move(anim->deletedRef));
+        }
+        d->m_animations.remove(id);
+        damageDirty = true;
+
+        if (entry->animations.isEmpty()) {
+            disconnect(window, &EffectWindow::windowExpandedGeometryChanged,
                        this, &AnimationEffect::_windowExpandedGeometryChanged);
-            effects->addRepaint(entry->second);
-            entry = d->m_animations.erase(entry);
+            effects->addRepaint(entry->layerRect);
+            d->m_animations.remove(window);
         } else {
-            if (invalidateLayerRect) {
-                *const_cast<QRect *>(&(entry->second)) = QRect(); // invalidate
-            }
-            ++entry;
+            entry->layerRect = QRect(); // invalidate
         }
     }
 
@@ -718,13 +673,14 @@ void AnimationEffect::postPaintScreen()
     if (d->m_needSceneRepaint) {
         effects->addRepaintFull();
     } else {
-        for (auto entry = d->m_animations.constBegin(); entry != d->m_animations.constEnd(); ++entry) {
-            for (auto anim = entry->first.constBegin(); anim != entry->first.constEnd(); ++anim) {
-                if (anim->startTime > clock()) {
+        const qint64 now = clock();
+        for (const AnimationTable::Entry &entry : d->m_animations) {
+            for (const AniData &anim : entry.animations) {
+                if (anim.startTime > now) {
                     continue;
                 }
-                if (!anim->timeLine.done()) {
-                    entry.key()->addLayerRepaint(entry->second);
+                if (!anim.timeLine.done()) {
+                    entry.window->addLayerRepaint(entry.layerRect);
                     break;
                 }
             }
@@ -808,16 +764,15 @@ void AnimationEffect::setMetaData(MetaType type, uint value, uint &meta)
 void AnimationEffect::triggerRepaint()
 {
     Q_D(AnimationEffect);
-    for (AniMap::const_iterator entry = d->m_animations.constBegin(), mapEnd = d->m_animations.constEnd(); entry != mapEnd; ++entry) {
-        *const_cast<QRect *>(&(entry->second)) = QRect();
+    for (AnimationTable::Entry &entry : d->m_animations) {
+        entry.layerRect = QRect();
     }
     updateLayerRepaints();
     if (d->m_needSceneRepaint) {
         effects->addRepaintFull();
     } else {
-        AniMap::const_iterator it = d->m_animations.constBegin(), end = d->m_animations.constEnd();
-        for (; it != end; ++it) {
-            it.key()->addLayerRepaint(it->second);
+        for (const AnimationTable::Entry &entry : d->m_animations) {
+            entry.window->addLayerRepaint(entry.layerRect);
         }
     }
 }
@@ -844,17 +799,18 @@ void AnimationEffect::updateLayerRepaints()
 {
     Q_D(AnimationEffect);
     d->m_needSceneRepaint = false;
-    for (AniMap::const_iterator entry = d->m_animations.constBegin(), mapEnd = d->m_animations.constEnd(); entry != mapEnd; ++entry) {
-        if (!entry->second.isNull()) {
+    const qint64 now = clock();
+    for (AnimationTable::Entry &entry : d->m_animations) {
+        if (!entry.layerRect.isNull()) {
             continue;
         }
         float f[2] = {1.0, 1.0};
         float t[2] = {0.0, 0.0};
         bool createRegion = false;
         QList<QRect> rects;
-        QRect *layerRect = const_cast<QRect *>(&(entry->second));
-        for (QList<AniData>::const_iterator anim = entry->first.constBegin(), animEnd = entry->first.constEnd(); anim != animEnd; ++anim) {
-            if (anim->startTime > clock()) {
+        QRect *layerRect = &entry.layerRect;
+        for (auto anim = entry.animations.cbegin(), animEnd = entry.animations.cend(); anim != animEnd; ++anim) {
+            if (anim->startTime > now) {
                 continue;
             }
             switch (anim->attribute) {
@@ -876,7 +832,7 @@ void AnimationEffect::updateLayerRepaints()
             case Translation:
             case Position: {
                 createRegion = true;
-                QRect r(entry.key()->frameGeometry().toRect());
+                QRect r(entry.window->frameGeometry().toRect());
                 int x[2] = {0, 0};
                 int y[2] = {0, 0};
                 if (anim->attribute == Translation) {
@@ -894,7 +850,7 @@ void AnimationEffect::updateLayerRepaints()
                         y[1] = anim->to[1] - yCoord(r, metaData(TargetAnchor, anim->meta));
                     }
                 }
-                r = entry.key()->expandedGeometry().toRect();
+                r = entry.window->expandedGeometry().toRect();
                 rects << r.translated(x[0], y[0]) << r.translated(x[1], y[1]);
                 break;
             }
@@ -904,7 +860,7 @@ void AnimationEffect::updateLayerRepaints()
             case Size:
             case Scale: {
                 createRegion = true;
-                const QSize sz = entry.key()->frameGeometry().size().toSize();
+                const QSize sz = entry.window->frameGeometry().size().toSize();
                 float fx = std::max(fixOvershoot(anim->from[0], *anim, 1), fixOvershoot(anim->to[0], *anim, 2));
                 //                     float fx = std::max(interpolated(*anim,0), anim->to[0]);
                 if (fx >= 0.0) {
@@ -934,7 +890,7 @@ void AnimationEffect::updateLayerRepaints()
         }
     region_creation:
         if (createRegion) {
-            const QRect geo = entry.key()->expandedGeometry().toRect();
+            const QRect geo = entry.window->expandedGeometry().toRect();
             if (rects.isEmpty()) {
                 rects << geo;
             }
@@ -960,12 +916,11 @@ void AnimationEffect::updateLayerRepaints()
 void AnimationEffect::_windowExpandedGeometryChanged(KWin::EffectWindow *w)
 {
     Q_D(AnimationEffect);
-    AniMap::const_iterator entry = d->m_animations.constFind(w);
-    if (entry != d->m_animations.constEnd()) {
-        *const_cast<QRect *>(&(entry->second)) = QRect();
+    if (AnimationTable::Entry *entry = d->m_animations.find(w)) {
+        entry->layerRect = QRect();
         updateLayerRepaints();
-        if (!entry->second.isNull()) { // actually got updated, ie. is in use - ensure it get's a repaint
-            w->addLayerRepaint(entry->second);
+        if (!entry->layerRect.isNull()) { // actually got updated, ie. is in use - ensure it get's a repaint
+            w->addLayerRepaint(entry->layerRect);
         }
     }
 }
@@ -974,15 +929,14 @@ void AnimationEffect::_windowClosed(EffectWindow *w)
 {
     Q_D(AnimationEffect);
 
-    auto it = d->m_animations.find(w);
-    if (it == d->m_animations.end()) {
+    AnimationTable::Entry *entry = d->m_animations.find(w);
+    if (!entry) {
         return;
     }
 
-    QList<AniData> &animations = (*it).first;
-    for (auto animationIt = animations.begin(); animationIt != animations.end(); ++animationIt) {
-        if (animationIt->keepAlive) {
-            animationIt->deletedRef = EffectWindowDeletedRef(w);
+    for (AniData &animation : entry->animations) {
+        if (animation.keepAlive) {
+            animation.deletedRef = EffectWindowDeletedRef(w);
         }
     }
 }
@@ -1000,16 +954,14 @@ QString AnimationEffect::debug(const QString & /*parameter*/) const
     if (d->m_animations.isEmpty()) {
         dbg = QStringLiteral("No window is animated");
     } else {
-        AniMap::const_iterator entry = d->m_animations.constBegin(), mapEnd = d->m_animations.constEnd();
-        for (; entry != mapEnd; ++entry) {
-            QString caption = entry.key()->isDeleted() ? QStringLiteral("[Deleted]") : entry.key()->caption();
+        for (const AnimationTable::Entry &entry : d->m_animations) {
+            QString caption = entry.window->isDeleted() ? QStringLiteral("[Deleted]") : entry.window->caption();
             if (caption.isEmpty()) {
                 caption = QStringLiteral("[Untitled]");
             }
             dbg += QLatin1String("Animating window: ") + caption + QLatin1Char('\n');
-            QList<AniData>::const_iterator anim = entry->first.constBegin(), animEnd = entry->first.constEnd();
-            for (; anim != animEnd; ++anim) {
-                dbg += anim->debugInfo();
+            for (const AniData &anim : entry.animations) {
+                dbg += anim.debugInfo();
             }
         }
     }
@@ -1019,7 +971,11 @@ QString AnimationEffect::debug(const QString & /*parameter*/) const
 AnimationEffect::AniMap AnimationEffect::state() const
 {
     Q_D(const AnimationEffect);
-    return d->m_animations;
+    AniMap map;
+    for (const AnimationTable::Entry &entry : d->m_animations) {
+        map.insert(entry.window, qMakePair(entry.animations, entry.layerRect));
+    }
+    return map;
 }
 
 } // namespace KWin
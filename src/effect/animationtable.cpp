@@ -0,0 +1,166 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "effect/animationtable_p.h"
+
+namespace KWin
+{
+
+bool AnimationTable::isEmpty() const
+{
+    return m_entries.empty();
+}
+
+qsizetype AnimationTable::count() const
+{
+    return m_entries.size();
+}
+
+bool AnimationTable::contains(EffectWindow *window) const
+{
+    return m_windows.contains(window);
+}
+
+std::vector<AnimationTable::Entry>::iterator AnimationTable::begin()
+{
+    return m_entries.begin();
+}
+
+std::vector<AnimationTable::Entry>::iterator AnimationTable::end()
+{
+    return m_entries.end();
+}
+
+std::vector<AnimationTable::Entry>::const_iterator AnimationTable::begin() const
+{
+    return m_entries.begin();
+}
+
+std::vector<AnimationTable::Entry>::const_iterator AnimationTable::end() const
+{
+    return m_entries.end();
+}
+
+AnimationTable::Entry *AnimationTable::find(EffectWindow *window)
+{
+    const auto it = m_windows.constFind(window);
+    if (it == m_windows.constEnd()) {
+        return nullptr;
+    }
+    return &m_entries[*it];
+}
+
+const AnimationTable::Entry *AnimationTable::find(EffectWindow *window) const
+{
+    const auto it = m_windows.constFind(window);
+    if (it == m_windows.constEnd()) {
+        return nullptr;
+    }
+    return &m_entries[*it];
+}
+
+AniData *AnimationTable::animation(quint64 id, Entry **entry)
+{
+    Entry *windowEntry = find(m_animations.value(id));
+    if (!windowEntry) {
+        return nullptr;
+    }
+    for (AniData &animation : windowEntry->animations) {
+        if (animation.id == id) {
+            if (entry) {
+                *entry = windowEntry;
+            }
+            return &animation;
+        }
+    }
+    return nullptr;
+}
+
+AnimationTable::Entry &AnimationTable::add(EffectWindow *window, AniData &&animation)
+{
+    m_animations.insert(animation.id, window);
+
+    Entry *entry = find(window);
+    if (!entry) {
+        m_windows.insert(window, m_entries.size());
+        entry = &m_entries.emplace_back(Entry{
+            .window = window,
+            .animations = {},
+            .layerRect = QRect(),
+        });
+    }
+    entry->animations.append(std::move(animation));
+    return *entry;
+}
+
+void AnimationTable::remove(quint64 id)
+{
+    Entry *entry = find(m_animations.take(id));
+    if (!entry) {
+        return;
+    }
+    entry->animations.removeIf([id](const AniData &animation) {
+        return animation.id == id;
+    });
+}
+
+void AnimationTable::remove(EffectWindow *window)
+{
+    const auto it = m_windows.constFind(window);
+    if (it == m_windows.constEnd()) {
+        return;
+    }
+    const qsizetype index = *it;
+    m_windows.erase(it);
+
+    for (const AniData &animation : std::as_const(m_entries[index].animations)) {
+        m_animations.remove(animation.id);
+    }
+
+    if (index != qsizetype(m_entries.size()) - 1) {
+        m_entries[index] = std::move(m_entries.back());
+        m_windows[m_entries[index].window] = index;
+    }
+    m_entries.pop_back();
+}
+
+void AnimationTable::clear()
+{
+    m_entries.clear();
+    m_windows.clear();
+    m_animations.clear();
+}
+
+void AnimationTable::advance(Entry &entry, std::chrono::milliseconds presentTime, qint64 now)
+{
+    for (AniData &animation : entry.animations) {
+        if (animation.startTime > now && !animation.waitAtSource) {
+            continue;
+        }
+        if (animation.frozenTime < 0) {
+            animation.timeLine.advance(presentTime);
+        }
+    }
+}
+
+QList<quint64> AnimationTable::finished(qint64 now) const
+{
+    QList<quint64> ids;
+    for (const Entry &entry : m_entries) {
+        for (const AniData &animation : entry.animations) {
+            if (animation.isActive() || (animation.startTime > now && !animation.waitAtSource)) {
+                continue;
+            }
+            ids.append(animation.id);
+        }
+    }
+    return ids;
+}
+
+} // namespace KWin
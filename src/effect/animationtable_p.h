@@ -0,0 +1,91 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "effect/anidata_p.h"
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+
+#include <vector>
+
+namespace KWin
+{
+
+/**
+ * The AnimationTable class stores the animations of an AnimationEffect.
+ *
+ * The animated windows are kept in a dense array, each with its animations in the order
+ * they were started. A window is found by a hash lookup and an animation by its id, so no
+ * operation walks the whole table except looking for finished animations. Removing a window moves the
+ * last window into its slot, pointers to entries are invalidated by add() and remove().
+ */
+class KWIN_EXPORT AnimationTable
+{
+public:
+    struct Entry
+    {
+        EffectWindow *window;
+        QList<AniData> animations;
+        // The area that has to be repainted while the window is animated, null if unknown
+        QRect layerRect;
+    };
+
+    bool isEmpty() const;
+    qsizetype count() const;
+    bool contains(EffectWindow *window) const;
+
+    std::vector<Entry>::iterator begin();
+    std::vector<Entry>::iterator end();
+    std::vector<Entry>::const_iterator begin() const;
+    std::vector<Entry>::const_iterator end() const;
+
+    Entry *find(EffectWindow *window);
+    const Entry *find(EffectWindow *window) const;
+
+    /**
+     * Returns the animation with the given @a id, or @c nullptr if there's no such
+     * animation. If @a entry is not null, it's set to the entry of the animated window.
+     */
+    AniData *animation(quint64 id, Entry **entry = nullptr);
+
+    /**
+     * Appends the @a animation to the animations of the @a window. The id of the animation
+     * must be set and unique.
+     */
+    Entry &add(EffectWindow *window, AniData &&animation);
+
+    /**
+     * Removes the animation with the given @a id. The entry of its window is kept even if
+     * it has no animations anymore.
+     */
+    void remove(quint64 id);
+    void remove(EffectWindow *window);
+    void clear();
+
+    /**
+     * Advances the time lines of the animations in the given @a entry that have started at
+     * @a now, which is the AnimationEffect::clock() time, to @a presentTime.
+     */
+    static void advance(Entry &entry, std::chrono::milliseconds presentTime, qint64 now);
+
+    /**
+     * Returns the ids of all animations that are over at @a now.
+     */
+    QList<quint64> finished(qint64 now) const;
+
+private:
+    std::vector<Entry> m_entries;
+    QHash<EffectWindow *, qsizetype> m_windows;
+    QHash<quint64, EffectWindow *> m_animations;
+};
+
+} // namespace KWin
@@ -93,8 +93,8 @@ EffectWindow::EffectWindow(WindowItem *windowItem)
     connect(d->m_window, &Window::frameGeometryChanged, this, [this](const QRectF &oldGeometry) {
         Q_EMIT windowFrameGeometryChanged(this, oldGeometry);
     });
-    connect(d->m_window, &Window::damaged, this, [this]() {
-        Q_EMIT windowDamaged(this);
+    connect(d->m_window, &Window::damaged, this, [this](Window *, const QRegion &region) {
+        Q_EMIT windowDamaged(this, region);
     });
     connect(d->m_window, &Window::unresponsiveChanged, this, [this](bool unresponsive) {
         Q_EMIT windowUnresponsiveChanged(this, unresponsive);
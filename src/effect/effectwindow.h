@@ -779,8 +779,9 @@ Q_SIGNALS:
      * Signal emitted when an area of a window is scheduled for repainting.
      * Use this signal in an effect if another area needs to be synced as well.
      * @param w The window which is scheduled for repainting
+     * @param region The damaged area, in global logical coordinates
      */
-    void windowDamaged(KWin::EffectWindow *w);
+    void windowDamaged(KWin::EffectWindow *w, const QRegion &region);
 
     /**
      * This signal is emitted when the keep above state of @p w was changed.
@@ -15,11 +15,95 @@
 namespace KWin
 {
 
+// Offscreen textures are allocated in steps, so windows that are resized or redirected
+// over and over again can reuse them
+static constexpr int s_textureSizeStep = 64;
+static constexpr size_t s_maxPooledTextures = 8;
+
+static QSize pooledTextureSize(const QSize &size)
+{
+    const auto roundUp = [](int value) {
+        return (value + s_textureSizeStep - 1) / s_textureSizeStep * s_textureSizeStep;
+    };
+    return QSize(roundUp(size.width()), roundUp(size.height()));
+}
+
+struct OffscreenTexture
+{
+    std::unique_ptr<GLTexture> texture;
+    std::unique_ptr<GLFramebuffer> fbo;
+};
+
+/**
+ * The OffscreenTexturePool class keeps the textures of unredirected windows around so they
+ * can be reused by the next redirected window with a similar size. The pool is shared by
+ * all offscreen effects, it lives as long as any of them.
+ */
+class OffscreenTexturePool
+{
+public:
+    static std::shared_ptr<OffscreenTexturePool> instance();
+
+    OffscreenTexture acquire(const QSize &size);
+    void release(OffscreenTexture &&texture);
+
+private:
+    // The most recently released textures are at the back
+    std::vector<OffscreenTexture> m_textures;
+};
+
+std::shared_ptr<OffscreenTexturePool> OffscreenTexturePool::instance()
+{
+    static std::weak_ptr<OffscreenTexturePool> s_pool;
+    std::shared_ptr<OffscreenTexturePool> pool = s_pool.lock();
+    if (!pool) {
+        pool = std::make_shared<OffscreenTexturePool>();
+        s_pool = pool;
+    }
+    return pool;
+}
+
+OffscreenTexture OffscreenTexturePool::acquire(const QSize &size)
+{
+    const QSize textureSize = pooledTextureSize(size);
+    for (auto it = m_textures.rbegin(); it != m_textures.rend(); ++it) {
+        if (it->texture->size() == textureSize) {
+            OffscreenTexture texture = std::move(*it);
+            m_textures.erase(std::next(it).base());
+            return texture;
+        }
+    }
+
+    std::unique_ptr<GLTexture> texture = GLTexture::allocate(GL_RGBA8, textureSize);
+    if (!texture) {
+        return OffscreenTexture{};
+    }
+    texture->setFilter(GL_LINEAR);
+    texture->setWrapMode(GL_CLAMP_TO_EDGE);
+    auto fbo = std::make_unique<GLFramebuffer>(texture.get());
+    return OffscreenTexture{
+        .texture = std::move(texture),
+        .fbo = std::move(fbo),
+    };
+}
+
+void OffscreenTexturePool::release(OffscreenTexture &&texture)
+{
+    if (!texture.texture) {
+        return;
+    }
+    m_textures.push_back(std::move(texture));
+    if (m_textures.size() > s_maxPooledTextures) {
+        m_textures.erase(m_textures.begin());
+    }
+}
+
 struct OffscreenData
 {
 public:
+    OffscreenData();
     virtual ~OffscreenData();
-    void setDirty();
+    void addDamage(EffectWindow *window, const QRegion &region);
     void setShader(GLShader *newShader);
     void setVertexSnappingMode(RenderGeometry::VertexSnappingMode mode);
 
@@ -28,9 +112,13 @@ public:
 
     void maybeRender(EffectWindow *window);
 
-    std::unique_ptr<GLTexture> m_texture;
-    std::unique_ptr<GLFramebuffer> m_fbo;
+    std::shared_ptr<OffscreenTexturePool> m_pool;
+    // The texture can be larger than the window, the window is in its top-left corner
+    OffscreenTexture m_offscreen;
+    QSize m_contentSize;
     bool m_isDirty = true;
+    // Relative to the top-left corner of the expanded geometry, the window can move before it's rendered
+    QRegion m_damage;
     GLShader *m_shader = nullptr;
     RenderGeometry::VertexSnappingMode m_vertexSnappingMode = RenderGeometry::VertexSnappingMode::Round;
     QMetaObject::Connection m_windowDamagedConnection;
@@ -39,6 +127,7 @@ public:
 class OffscreenEffectPrivate
 {
 public:
+    std::shared_ptr<OffscreenTexturePool> texturePool = OffscreenTexturePool::instance();
     std::map<EffectWindow *, std::unique_ptr<OffscreenData>> windows;
     QMetaObject::Connection windowDeletedConnection;
     RenderGeometry::VertexSnappingMode vertexSnappingMode = RenderGeometry::VertexSnappingMode::Round;
@@ -93,55 +182,103 @@ void OffscreenEffect::apply(EffectWindow *window, int mask, WindowPaintData &dat
 {
 }
 
+/**
+ * Moves the @a region by the given fractional @a offset, every rect grows to the pixels it touches.
+ */
+static QRegion translatedRegion(const QRegion &region, const QPointF &offset)
+{
+    QRegion result;
+    for (const QRect &rect : region) {
+        result += QRectF(rect).translated(offset).toAlignedRect();
+    }
+    return result;
+}
+
 void OffscreenData::maybeRender(EffectWindow *window)
 {
     const QRectF logicalGeometry = window->expandedGeometry();
     const qreal scale = window->screen()->scale();
-    const QSize textureSize = (logicalGeometry.size() * scale).toSize();
-
-    if (!m_texture || m_texture->size() != textureSize) {
-        m_texture = GLTexture::allocate(GL_RGBA8, textureSize);
-        if (!m_texture) {
-            return;
+    const QSize contentSize = (logicalGeometry.size() * scale).toSize();
+
+    if (!m_offscreen.texture || m_contentSize != contentSize) {
+        if (!m_offscreen.texture || m_offscreen.texture->size() != pooledTextureSize(contentSize)) {
+            m_pool->release(std::move(m_offscreen));
+            m_offscreen = m_pool->acquire(contentSize);
+            if (!m_offscreen.texture) {
+                return;
+            }
         }
-        m_texture->setFilter(GL_LINEAR);
-        m_texture->setWrapMode(GL_CLAMP_TO_EDGE);
-        m_fbo = std::make_unique<GLFramebuffer>(m_texture.get());
+        m_contentSize = contentSize;
         m_isDirty = true;
     }
 
+    QRegion dirtyRegion;
     if (m_isDirty) {
-        RenderTarget renderTarget(m_fbo.get());
-        RenderViewport viewport(logicalGeometry, scale, renderTarget);
-        GLFramebuffer::pushFramebuffer(m_fbo.get());
-        glClearColor(0.0, 0.0, 0.0, 0.0);
+        dirtyRegion = infiniteRegion();
+    } else {
+        dirtyRegion = translatedRegion(m_damage, logicalGeometry.topLeft()) & logicalGeometry.toAlignedRect();
+        if (dirtyRegion.isEmpty()) {
+            return;
+        }
+    }
+
+    GLTexture *texture = m_offscreen.texture.get();
+    GLFramebuffer *fbo = m_offscreen.fbo.get();
+
+    // The viewport covers the whole texture, so it stays intact if another framebuffer is
+    // pushed and popped while the window is being painted
+    RenderTarget renderTarget(fbo);
+    RenderViewport viewport(QRectF(logicalGeometry.topLeft(), QSizeF(texture->size()) / scale), scale, renderTarget);
+    GLFramebuffer::pushFramebuffer(fbo);
+    glClearColor(0.0, 0.0, 0.0, 0.0);
+    if (dirtyRegion == infiniteRegion()) {
         glClear(GL_COLOR_BUFFER_BIT);
+    } else {
+        // Only the damaged area is painted again, the rest of the texture is still valid
+        glEnable(GL_SCISSOR_TEST);
+        for (const QRect &rect : viewport.mapToRenderTarget(dirtyRegion)) {
+            glScissor(rect.x(), texture->height() - (rect.y() + rect.height()), rect.width(), rect.height());
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        glDisable(GL_SCISSOR_TEST);
+    }
 
-        QMatrix4x4 projectionMatrix;
-        projectionMatrix.ortho(QRectF(0, 0, textureSize.width(), textureSize.height()));
+    QMatrix4x4 projectionMatrix;
+    projectionMatrix.ortho(QRectF(0, 0, texture->width(), texture->height()));
 
-        WindowPaintData data;
-        data.setXTranslation(-logicalGeometry.x());
-        data.setYTranslation(-logicalGeometry.y());
-        data.setOpacity(1.0);
-        data.setProjectionMatrix(projectionMatrix);
+    WindowPaintData data;
+    data.setXTranslation(-logicalGeometry.x());
+    data.setYTranslation(-logicalGeometry.y());
+    data.setOpacity(1.0);
+    data.setProjectionMatrix(projectionMatrix);
 
-        const int mask = Effect::PAINT_WINDOW_TRANSFORMED | Effect::PAINT_WINDOW_TRANSLUCENT;
-        effects->drawWindow(renderTarget, viewport, window, mask, infiniteRegion(), data);
+    const int mask = Effect::PAINT_WINDOW_TRANSFORMED | Effect::PAINT_WINDOW_TRANSLUCENT;
+    effects->drawWindow(renderTarget, viewport, window, mask, dirtyRegion, data);
 
-        GLFramebuffer::popFramebuffer();
-        m_isDirty = false;
-    }
+    GLFramebuffer::popFramebuffer();
+    m_isDirty = false;
+    m_damage = QRegion();
+}
+
+OffscreenData::OffscreenData()
+    : m_pool(OffscreenTexturePool::instance())
+{
 }
 
 OffscreenData::~OffscreenData()
 {
     QObject::disconnect(m_windowDamagedConnection);
+    m_pool->release(std::move(m_offscreen));
 }
 
-void OffscreenData::setDirty()
+void OffscreenData::addDamage(EffectWindow *window, const QRegion &region)
 {
-    m_isDirty = true;
+    if (region == infiniteRegion()) {
+        m_isDirty = true;
+        m_damage = QRegion();
+    } else if (!m_isDirty) {
+        m_damage += translatedRegion(region, -window->expandedGeometry().topLeft());
+    }
 }
 
 void OffscreenData::setShader(GLShader *newShader)
@@ -171,7 +308,14 @@ void OffscreenData::paint(const RenderTarget &renderTarget, const RenderViewport
     for (auto &quad : quads) {
         geometry.appendWindowQuad(quad, scale);
     }
-    geometry.postProcessTextureCoordinates(m_texture->matrix(NormalizedCoordinates));
+
+    // Map the texture coordinates of the window to the top-left corner of the texture
+    GLTexture *texture = m_offscreen.texture.get();
+    QMatrix4x4 textureMatrix;
+    textureMatrix.translate(0, 1);
+    textureMatrix.scale(qreal(m_contentSize.width()) / texture->width(), qreal(m_contentSize.height()) / texture->height());
+    textureMatrix.translate(0, -1);
+    geometry.postProcessTextureCoordinates(textureMatrix * texture->matrix(NormalizedCoordinates));
 
     const auto map = vbo->map<GLVertex2D>(geometry.size());
     if (!map) {
@@ -193,8 +337,8 @@ void OffscreenData::paint(const RenderTarget &renderTarget, const RenderViewport
     shader->setUniform(GLShader::ModulationConstant, QVector4D(rgb, rgb, rgb, a));
     shader->setUniform(GLShader::Saturation, data.saturation());
     shader->setUniform(GLShader::Vec3Uniform::PrimaryBrightness, QVector3D(toXYZ(1, 0), toXYZ(1, 1), toXYZ(1, 2)));
-    shader->setUniform(GLShader::TextureWidth, m_texture->width());
-    shader->setUniform(GLShader::TextureHeight, m_texture->height());
+    shader->setUniform(GLShader::TextureWidth, texture->width());
+    shader->setUniform(GLShader::TextureHeight, texture->height());
     shader->setColorspaceUniformsFromSRGB(renderTarget.colorDescription());
 
     const bool clipping = region != infiniteRegion();
@@ -207,9 +351,9 @@ void OffscreenData::paint(const RenderTarget &renderTarget, const RenderViewport
     glEnable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-    m_texture->bind();
+    texture->bind();
     vbo->draw(clipRegion, GL_TRIANGLES, 0, geometry.count(), clipping);
-    m_texture->unbind();
+    texture->unbind();
 
     glDisable(GL_BLEND);
     if (clipping) {
@@ -246,10 +390,10 @@ void OffscreenEffect::drawWindow(const RenderTarget &renderTarget, const RenderV
     offscreenData->paint(renderTarget, viewport, window, region, data, quads);
 }
 
-void OffscreenEffect::handleWindowDamaged(EffectWindow *window)
+void OffscreenEffect::handleWindowDamaged(EffectWindow *window, const QRegion &region)
 {
     if (const auto it = d->windows.find(window); it != d->windows.end()) {
-        it->second->setDirty();
+        it->second->addDamage(window, region);
     }
 }
 
@@ -289,6 +433,7 @@ public:
 class CrossFadeEffectPrivate
 {
 public:
+    std::shared_ptr<OffscreenTexturePool> texturePool = OffscreenTexturePool::instance();
     std::map<EffectWindow *, std::unique_ptr<CrossFadeWindowData>> windows;
     qreal progress;
 };
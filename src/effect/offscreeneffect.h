@@ -73,7 +73,7 @@ protected:
     void setVertexSnappingMode(RenderGeometry::VertexSnappingMode mode);
 
 private Q_SLOTS:
-    void handleWindowDamaged(EffectWindow *window);
+    void handleWindowDamaged(EffectWindow *window, const QRegion &region);
     void handleWindowDeleted(EffectWindow *window);
 
 private:
@@ -80,6 +80,7 @@
 #include "x11window.h"
 
 #include <array>
+#include <deque>
 
 #include <QDebug>
 
@@ -525,6 +526,140 @@ static Layer computeLayer(const Window *window)
     }
 }
 
+namespace
+{
+
+/**
+ * A list of windows that supports moving a window and comparing the positions of two windows
+ * in constant time, unlike QList where both are linear in the number of windows.
+ *
+ * The windows are kept in a doubly linked list. Every node carries a label that increases from
+ * the bottom to the top. A moved window gets the label in the middle between its new neighbors,
+ * the labels are spaced out again in the rare case that there is no gap left.
+ */
+class StackingList
+{
+public:
+    explicit StackingList(qsizetype size)
+    {
+        m_index.reserve(size);
+    }
+
+    void append(Window *window)
+    {
+        Node *node = &m_nodes.emplace_back(Node{
+            .window = window,
+            .previous = m_last,
+            .label = (m_last ? m_last->label : 0) + s_spacing,
+        });
+        if (m_last) {
+            m_last->next = node;
+        } else {
+            m_first = node;
+        }
+        m_last = node;
+        m_index.insert(window, node);
+    }
+
+    bool contains(Window *window) const
+    {
+        return m_index.contains(window);
+    }
+
+    /**
+     * Returns a value that is greater for windows that are higher in the stack. Windows that
+     * are not in the list are below every other window.
+     */
+    quint64 position(Window *window) const
+    {
+        const Node *node = m_index.value(window);
+        return node ? node->label : 0;
+    }
+
+    /**
+     * Moves the @a window so it's directly above the window @a below.
+     */
+    void moveAbove(Window *window, Window *below)
+    {
+        Node *node = m_index.value(window);
+        Node *belowNode = m_index.value(below);
+        if (node == belowNode || belowNode->next == node) {
+            return;
+        }
+
+        unlink(node);
+
+        Node *aboveNode = belowNode->next;
+        if (aboveNode && aboveNode->label - belowNode->label < 2) {
+            relabel();
+        }
+        node->label = aboveNode ? belowNode->label + (aboveNode->label - belowNode->label) / 2 : belowNode->label + s_spacing;
+
+        node->previous = belowNode;
+        node->next = aboveNode;
+        belowNode->next = node;
+        if (aboveNode) {
+            aboveNode->previous = node;
+        } else {
+            m_last = node;
+        }
+    }
+
+    QList<Window *> toList() const
+    {
+        QList<Window *> windows;
+        windows.reserve(m_index.size());
+        for (const Node *node = m_first; node; node = node->next) {
+            windows.append(node->window);
+        }
+        return windows;
+    }
+
+private:
+    struct Node
+    {
+        Window *window = nullptr;
+        Node *previous = nullptr;
+        Node *next = nullptr;
+        quint64 label = 0;
+    };
+
+    void unlink(Node *node)
+    {
+        if (node->previous) {
+            node->previous->next = node->next;
+        } else {
+            m_first = node->next;
+        }
+        if (node->next) {
+            node->next->previous = node->previous;
+        } else {
+            m_last = node->previous;
+        }
+        node->previous = nullptr;
+        node->next = nullptr;
+    }
+
+    void relabel()
+    {
+        quint64 label = 0;
+        for (Node *node = m_first; node; node = node->next) {
+            label += s_spacing;
+            node->label = label;
+        }
+    }
+
+    static constexpr quint64 s_spacing = quint64(1) << 32;
+
+    // std::deque doesn't move the nodes when appending
+    std::deque<Node> m_nodes;
+    QHash<Window *, Node *> m_index;
+    Node *m_first = nullptr;
+    Node *m_last = nullptr;
+};
+
+} // namespace
+
 /**
  * Returns a stacking order based upon \a list that fulfills certain contained.
  */
@@ -538,10 +673,11 @@ QList<Window *> Workspace::constrainedStackingOrder()
         windows[layer] << window;
     }
 
-    QList<Window *> stacking;
-    stacking.reserve(unconstrained_stacking_order.count());
+    StackingList stacking(unconstrained_stacking_order.count());
     for (uint layer = FirstLayer; layer < NumLayers; ++layer) {
-        stacking += windows[layer];
+        for (Window *window : std::as_const(windows[layer])) {
+            stacking.append(window);
+        }
     }
 
     // Apply the stacking order constraints. First, we enqueue the root constraints, i.e.
@@ -559,23 +695,20 @@ QList<Window *> Workspace::constrainedStackingOrder()
 
     // Preserve the relative order of transient siblings in the unconstrained stacking order.
     auto constraintComparator = [&stacking](Constraint *a, Constraint *b) {
-        return stacking.indexOf(a->above) > stacking.indexOf(b->above);
+        return stacking.position(a->above) > stacking.position(b->above);
     };
     std::sort(constraints.begin(), constraints.end(), constraintComparator);
 
     // Once we've enqueued all the root constraints, we traverse the constraints tree in
     // the reverse breadth-first search fashion. A constraint is applied only if its condition is
     // not met.
-    while (!constraints.isEmpty()) {
-        Constraint *constraint = constraints.takeFirst();
+    for (qsizetype i = 0; i < constraints.size(); ++i) {
+        Constraint *constraint = constraints[i];
 
-        const int belowIndex = stacking.indexOf(constraint->below);
-        const int aboveIndex = stacking.indexOf(constraint->above);
-        if (belowIndex == -1 || aboveIndex == -1) {
+        if (!stacking.contains(constraint->below) || !stacking.contains(constraint->above)) {
             continue;
-        } else if (aboveIndex < belowIndex) {
-            stacking.removeAt(aboveIndex);
-            stacking.insert(belowIndex, constraint->above);
+        } else if (stacking.position(constraint->above) < stacking.position(constraint->below)) {
+            stacking.moveAbove(constraint->above, constraint->below);
         }
 
         // Preserve the relative order of transient siblings in the unconstrained stacking order.
@@ -590,7 +723,7 @@ QList<Window *> Workspace::constrainedStackingOrder()
         }
     }
 
-    return stacking;
+    return stacking.toList();
 }
 
 void Workspace::blockStackingUpdates(bool block)
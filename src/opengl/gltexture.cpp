@@ -11,6 +11,7 @@
 
 #include "gltexture_p.h"
 #include "opengl/glplatform.h"
+#include "opengl/glunpackbuffer.h"
 #include "opengl/glutils.h"
 #include "opengl/glutils_funcs.h"
 #include "utils/common.h"
@@ -21,6 +22,8 @@
 #include <QVector3D>
 #include <QVector4D>
 
+#include <cstring>
+
 namespace KWin
 {
 
@@ -36,6 +39,7 @@ bool GLTexturePrivate::s_supportsTextureSwizzle = false;
 bool GLTexturePrivate::s_supportsTextureFormatRG = false;
 bool GLTexturePrivate::s_supportsTexture16Bit = false;
 uint GLTexturePrivate::s_fbo = 0;
+std::unique_ptr<GLUnpackBuffer> GLTexturePrivate::s_unpackBuffer;
 
 // Table of GL formats/types associated with different values of QImage::Format.
 // Zero values indicate a direct upload is not feasible.
@@ -165,6 +169,10 @@ void GLTexturePrivate::initStatic()
 
         s_supportsUnpack = hasGLExtension(QByteArrayLiteral("GL_EXT_unpack_subimage"));
     }
+
+    if (GLUnpackBuffer::isSupported()) {
+        s_unpackBuffer = std::make_unique<GLUnpackBuffer>();
+    }
 }
 
 void GLTexturePrivate::cleanup()
@@ -175,6 +183,7 @@ void GLTexturePrivate::cleanup()
         glDeleteFramebuffers(1, &s_fbo);
         s_fbo = 0;
     }
+    s_unpackBuffer.reset();
 }
 
 bool GLTexture::isNull() const
@@ -196,7 +205,69 @@ void GLTexture::setSize(const QSize &size)
     d->updateMatrix();
 }
 
-void GLTexture::update(const QImage &image, const QPoint &offset, const QRect &src)
+struct UploadFormat
+{
+    GLenum format;
+    GLenum type;
+    QImage::Format imageFormat;
+};
+
+static UploadFormat uploadFormatFor(QImage::Format format)
+{
+    if (!GLPlatform::instance()->isGLES()) {
+        if (format < sizeof(formatTable) / sizeof(formatTable[0]) && formatTable[format].internalFormat
+            && !(formatTable[format].type == GL_UNSIGNED_SHORT && !GLTexturePrivate::s_supportsTexture16Bit)) {
+            return UploadFormat{formatTable[format].format, formatTable[format].type, format};
+        } else {
+            return UploadFormat{GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, QImage::Format_ARGB32_Premultiplied};
+        }
+    } else {
+        if (GLTexturePrivate::s_supportsARGB32) {
+            return UploadFormat{GL_BGRA_EXT, GL_UNSIGNED_BYTE, QImage::Format_ARGB32_Premultiplied};
+        } else {
+            return UploadFormat{GL_RGBA, GL_UNSIGNED_BYTE, QImage::Format_RGBA8888_Premultiplied};
+        }
+    }
+}
+
+/**
+ * Merges the rectangles of the given region into fewer, larger rectangles as long as that
+ * doesn't add too many pixels that aren't actually damaged. Every transfer has a fixed cost,
+ * so uploading a few extra pixels is cheaper than issuing many small transfers.
+ */
+static QList<QRect> coalesceUploadRects(const QRegion &region)
+{
+    // Extra pixels that are always acceptable to merge two rectangles
+    static constexpr qint64 slack = 64 * 64;
+
+    QList<QRect> rects;
+    QRect current;
+    qint64 currentArea = 0;
+    for (const QRect &rect : region) {
+        const qint64 area = qint64(rect.width()) * rect.height();
+        if (current.isEmpty()) {
+            current = rect;
+            currentArea = area;
+            continue;
+        }
+        const QRect merged = current | rect;
+        const qint64 mergedArea = qint64(merged.width()) * merged.height();
+        if (mergedArea <= (currentArea + area) * 5 / 4 + slack) {
+            current = merged;
+            currentArea += area;
+        } else {
+            rects.append(current);
+            current = rect;
+            currentArea = area;
+        }
+    }
+    if (!current.isEmpty()) {
+        rects.append(current);
+    }
+    return rects;
+}
+
+void GLTexture::update(const QImage &image, const QRegion &region, const QPoint &offset)
 {
     if (image.isNull() || isNull()) {
         return;
@@ -204,33 +275,78 @@ void GLTexture::update(const QImage &image, const QPoint &offset, const QRect &s
 
     Q_ASSERT(d->m_owning);
 
-    GLenum glFormat;
-    GLenum type;
-    QImage::Format uploadFormat;
-    if (!GLPlatform::instance()->isGLES()) {
-        const QImage::Format index = image.format();
+    const QList<QRect> rects = coalesceUploadRects(region & image.rect());
+    if (rects.isEmpty()) {
+        return;
+    }
 
-        if (index < sizeof(formatTable) / sizeof(formatTable[0]) && formatTable[index].internalFormat
-            && !(formatTable[index].type == GL_UNSIGNED_SHORT && !d->s_supportsTexture16Bit)) {
-            glFormat = formatTable[index].format;
-            type = formatTable[index].type;
-            uploadFormat = index;
-        } else {
-            glFormat = GL_BGRA;
-            type = GL_UNSIGNED_INT_8_8_8_8_REV;
-            uploadFormat = QImage::Format_ARGB32_Premultiplied;
+    if (d->s_unpackBuffer) {
+        const UploadFormat format = uploadFormatFor(image.format());
+        if (image.format() == format.imageFormat && d->updateStreaming(image, rects, offset, format.format, format.type)) {
+            return;
         }
-    } else {
-        if (d->s_supportsARGB32) {
-            glFormat = GL_BGRA_EXT;
-            type = GL_UNSIGNED_BYTE;
-            uploadFormat = QImage::Format_ARGB32_Premultiplied;
-        } else {
-            glFormat = GL_RGBA;
-            type = GL_UNSIGNED_BYTE;
-            uploadFormat = QImage::Format_RGBA8888_Premultiplied;
+    }
+
+    for (const QRect &rect : rects) {
+        update(image, offset + rect.topLeft(), rect);
+    }
+}
+
+bool GLTexturePrivate::updateStreaming(const QImage &image, const QList<QRect> &rects, const QPoint &offset, GLenum format, GLenum type)
+{
+    Q_ASSERT(image.depth() % 8 == 0);
+    const int bytesPerPixel = image.depth() / 8;
+
+    size_t size = 0;
+    for (const QRect &rect : rects) {
+        size += size_t(rect.width()) * rect.height() * bytesPerPixel;
+    }
+
+    // If the GPU is still busy with the staging memory, fall back to a synchronous upload
+    // rather than waiting for it
+    const auto range = s_unpackBuffer->map(size);
+    if (!range) {
+        return false;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_unpackBuffer->buffer());
+    glBindTexture(m_target, m_texture);
+    // The rows are tightly packed in the staging buffer
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    uint8_t *data = range->data;
+    GLintptr dataOffset = range->offset;
+    for (const QRect &rect : rects) {
+        const size_t rowSize = size_t(rect.width()) * bytesPerPixel;
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            std::memcpy(data, image.constScanLine(y) + rect.x() * bytesPerPixel, rowSize);
+            data += rowSize;
         }
+
+        glTexSubImage2D(m_target, 0, offset.x() + rect.x(), offset.y() + rect.y(), rect.width(), rect.height(), format, type, reinterpret_cast<const void *>(dataOffset));
+        dataOffset += rowSize * rect.height();
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(m_target, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    s_unpackBuffer->unmap();
+    return true;
+}
+
+void GLTexture::update(const QImage &image, const QPoint &offset, const QRect &src)
+{
+    if (image.isNull() || isNull()) {
+        return;
     }
+
+    Q_ASSERT(d->m_owning);
+
+    const UploadFormat format = uploadFormatFor(image.format());
+    const GLenum glFormat = format.format;
+    const GLenum type = format.type;
+    const QImage::Format uploadFormat = format.imageFormat;
     bool useUnpack = d->s_supportsUnpack && image.format() == uploadFormat && !src.isNull();
 
     QImage im;
@@ -99,6 +99,15 @@ public:
     QMatrix4x4 matrix(TextureCoordinateType type) const;
 
     void update(const QImage &image, const QPoint &offset = QPoint(0, 0), const QRect &src = QRect());
+    /**
+     * Uploads the given @a region of the @a image to the texture, at the same position
+     * translated by @a offset.
+     *
+     * Nearby rectangles of the region are coalesced into a few larger transfers. If
+     * possible, the pixel data is staged in a persistently mapped pixel unpack buffer so
+     * the transfers can be performed asynchronously.
+     */
+    void update(const QImage &image, const QRegion &region, const QPoint &offset = QPoint(0, 0));
     void bind();
     void unbind();
     void render(const QSizeF &size);
@@ -22,6 +22,7 @@
 namespace KWin
 {
 // forward declarations
+class GLUnpackBuffer;
 class GLVertexBuffer;
 
 class KWIN_EXPORT GLTexturePrivate
@@ -32,6 +33,7 @@ public:
     virtual ~GLTexturePrivate();
 
     void updateMatrix();
+    bool updateStreaming(const QImage &image, const QList<QRect> &rects, const QPoint &offset, GLenum format, GLenum type);
 
     GLuint m_texture;
     GLenum m_target;
@@ -66,6 +68,7 @@ public:
     static bool s_supportsTextureFormatRG;
     static bool s_supportsTexture16Bit;
     static GLuint s_fbo;
+    static std::unique_ptr<GLUnpackBuffer> s_unpackBuffer;
 
 private:
     friend void KWin::cleanupGL();
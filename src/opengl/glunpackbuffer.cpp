@@ -0,0 +1,158 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "opengl/glunpackbuffer.h"
+#include "opengl/glplatform.h"
+#include "opengl/glutils.h"
+#include "utils/common.h"
+
+#include <bit>
+
+namespace KWin
+{
+
+static constexpr size_t s_minBufferSize = 4 * 1024 * 1024;
+static constexpr size_t s_maxBufferSize = 64 * 1024 * 1024;
+// glTexSubImage2D() requires the offset to be a multiple of the pixel type size
+static constexpr size_t s_alignment = 16;
+
+GLUnpackBuffer::~GLUnpackBuffer()
+{
+    reset();
+}
+
+bool GLUnpackBuffer::isSupported()
+{
+    if (qgetenv("KWIN_PERSISTENT_PBO") == QByteArrayLiteral("0")) {
+        return false;
+    }
+    if (GLPlatform::instance()->isGLES()) {
+        return hasGLVersion(3, 0) && hasGLExtension(QByteArrayLiteral("GL_EXT_buffer_storage"));
+    } else {
+        const bool haveBufferStorage = hasGLVersion(4, 4) || hasGLExtension(QByteArrayLiteral("GL_ARB_buffer_storage"));
+        const bool haveSyncFences = hasGLVersion(3, 2) || hasGLExtension(QByteArrayLiteral("GL_ARB_sync"));
+        const bool havePixelBufferObjects = hasGLVersion(2, 1) || hasGLExtension(QByteArrayLiteral("GL_ARB_pixel_buffer_object"));
+        return haveBufferStorage && haveSyncFences && havePixelBufferObjects;
+    }
+}
+
+GLuint GLUnpackBuffer::buffer() const
+{
+    return m_buffer;
+}
+
+std::optional<GLUnpackBuffer::Range> GLUnpackBuffer::map(size_t size)
+{
+    size = (size + s_alignment - 1) & ~(s_alignment - 1);
+    if (size > m_size) {
+        if (!reallocate(size)) {
+            return std::nullopt;
+        }
+    }
+
+    retireFences();
+
+    uint64_t start = m_head;
+    const size_t offset = start % m_size;
+    if (offset + size > m_size) {
+        // the range has to be contiguous, skip the remainder of the buffer
+        start += m_size - offset;
+    }
+    if (start + size - m_tail > m_size) {
+        return std::nullopt;
+    }
+
+    m_head = start + size;
+    return Range{
+        .offset = GLintptr(start % m_size),
+        .data = m_map + start % m_size,
+    };
+}
+
+void GLUnpackBuffer::unmap()
+{
+    if (m_head == m_fencedHead) {
+        return;
+    }
+    if (GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)) {
+        m_fences.push_back(Fence{
+            .sync = sync,
+            .end = m_head,
+        });
+        m_fencedHead = m_head;
+    } else {
+        // without a fence there's no way to tell when the memory is idle again
+        qCWarning(KWIN_OPENGL) << "Failed to create a fence for the pixel unpack buffer";
+        glFinish();
+        m_fencedHead = m_head;
+        m_tail = m_head;
+    }
+}
+
+void GLUnpackBuffer::retireFences()
+{
+    while (!m_fences.empty()) {
+        const Fence &fence = m_fences.front();
+        GLint status;
+        glGetSynciv(fence.sync, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED) {
+            break;
+        }
+        m_tail = fence.end;
+        glDeleteSync(fence.sync);
+        m_fences.pop_front();
+    }
+}
+
+bool GLUnpackBuffer::reallocate(size_t size)
+{
+    const size_t bufferSize = std::max(s_minBufferSize, std::bit_ceil(size * 2));
+    if (bufferSize > s_maxBufferSize) {
+        return false;
+    }
+
+    // Buffers that are still in use by pending commands are kept alive by the driver
+    reset();
+
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, access);
+    m_map = static_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bufferSize, access));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!m_map) {
+        qCWarning(KWIN_OPENGL) << "Failed to map the pixel unpack buffer";
+        reset();
+        return false;
+    }
+
+    m_size = bufferSize;
+    return true;
+}
+
+void GLUnpackBuffer::reset()
+{
+    for (const Fence &fence : m_fences) {
+        glDeleteSync(fence.sync);
+    }
+    m_fences.clear();
+
+    if (m_buffer) {
+        // This also unmaps the buffer
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+
+    m_map = nullptr;
+    m_size = 0;
+    m_head = 0;
+    m_tail = 0;
+    m_fencedHead = 0;
+}
+
+} // namespace KWin
@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <deque>
+#include <epoxy/gl.h>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The GLUnpackBuffer class is a ring of persistently mapped GL_PIXEL_UNPACK_BUFFER
+ * memory used to stream texture uploads.
+ *
+ * Pixel data is copied into an idle range of the ring and then handed to glTexSubImage2D()
+ * as an offset into the buffer, so the driver can perform the transfer asynchronously
+ * instead of reading from client memory while the compositor waits. A fence is inserted
+ * after every batch of transfers, the memory is reused only once the fence is signaled.
+ */
+class GLUnpackBuffer
+{
+public:
+    ~GLUnpackBuffer();
+
+    /**
+     * Returns @c true if persistently mapped pixel unpack buffers are supported.
+     */
+    static bool isSupported();
+
+    struct Range
+    {
+        GLintptr offset;
+        uint8_t *data;
+    };
+
+    /**
+     * Returns a range of @a size bytes that the GPU doesn't use anymore, or an empty
+     * optional if there's no such range available right now. This never stalls.
+     */
+    std::optional<Range> map(size_t size);
+    /**
+     * Inserts a fence protecting all ranges handed out since the last call.
+     */
+    void unmap();
+
+    GLuint buffer() const;
+
+private:
+    bool reallocate(size_t size);
+    void retireFences();
+    void reset();
+
+    struct Fence
+    {
+        GLsync sync;
+        uint64_t end;
+    };
+
+    GLuint m_buffer = 0;
+    uint8_t *m_map = nullptr;
+    size_t m_size = 0;
+    // The offsets are virtual, i.e. they keep increasing, the real offset is modulo m_size
+    uint64_t m_head = 0;
+    uint64_t m_tail = 0;
+    uint64_t m_fencedHead = 0;
+    std::deque<Fence> m_fences;
+};
+
+} // namespace KWin
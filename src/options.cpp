@@ -630,6 +630,20 @@ void Options::setAllowTearing(bool allow)
     }
 }
 
+qreal Options::renderTimePercentile() const
+{
+    return m_renderTimePercentile;
+}
+
+void Options::setRenderTimePercentile(qreal percentile)
+{
+    percentile = std::clamp(percentile, 50.0, 100.0);
+    if (percentile != m_renderTimePercentile) {
+        m_renderTimePercentile = percentile;
+        Q_EMIT renderTimePercentileChanged();
+    }
+}
+
 void Options::setGlPlatformInterface(OpenGLPlatformInterface interface)
 {
     // check environment variable
@@ -846,6 +860,7 @@ void Options::syncFromKcfgc()
     setElectricBorderCornerRatio(m_settings->electricBorderCornerRatio());
     setWindowsBlockCompositing(m_settings->windowsBlockCompositing());
     setAllowTearing(m_settings->allowTearing());
+    setRenderTimePercentile(m_settings->renderTimePercentile());
 }
 
 // restricted should be true for operations that the user may not be able to repeat
@@ -198,6 +198,11 @@ class KWIN_EXPORT Options : public QObject
     Q_PROPERTY(KWin::OpenGLPlatformInterface glPlatformInterface READ glPlatformInterface WRITE setGlPlatformInterface NOTIFY glPlatformInterfaceChanged)
     Q_PROPERTY(bool windowsBlockCompositing READ windowsBlockCompositing WRITE setWindowsBlockCompositing NOTIFY windowsBlockCompositingChanged)
     Q_PROPERTY(bool allowTearing READ allowTearing WRITE setAllowTearing NOTIFY allowTearingChanged)
+    /**
+     * The percentile of recent render times that is used to predict how long it will take
+     * to render the next frame. Lower values reduce latency at the risk of missing vblanks.
+     */
+    Q_PROPERTY(qreal renderTimePercentile READ renderTimePercentile WRITE setRenderTimePercentile NOTIFY renderTimePercentileChanged)
 public:
     explicit Options(QObject *parent = nullptr);
     ~Options() override;
@@ -686,6 +691,7 @@ public:
 
     QStringList modifierOnlyDBusShortcut(Qt::KeyboardModifier mod) const;
     bool allowTearing() const;
+    qreal renderTimePercentile() const;
 
     // setters
     void setFocusPolicy(FocusPolicy focusPolicy);
@@ -744,6 +750,7 @@ public:
     void setGlPlatformInterface(OpenGLPlatformInterface interface);
     void setWindowsBlockCompositing(bool set);
     void setAllowTearing(bool allow);
+    void setRenderTimePercentile(qreal percentile);
 
     // default values
     static WindowOperation defaultOperationTitlebarDblClick()
@@ -942,6 +949,7 @@ Q_SIGNALS:
     void animationSpeedChanged();
     void configChanged();
     void allowTearingChanged();
+    void renderTimePercentileChanged();
 
 private:
     void setElectricBorders(int borders);
@@ -1014,6 +1022,7 @@ private:
     bool condensed_title;
 
     bool m_allowTearing = true;
+    qreal m_renderTimePercentile = 99;
 
     QHash<Qt::KeyboardModifier, QStringList> m_modifierOnlyShortcuts;
 
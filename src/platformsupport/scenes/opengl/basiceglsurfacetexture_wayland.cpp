@@ -96,9 +96,7 @@ void BasicEGLSurfaceTextureWayland::updateShmTexture(GraphicsBuffer *buffer, con
         return;
     }
 
-    for (const QRect &rect : region) {
-        m_texture.planes[0]->update(*view.image(), rect.topLeft(), rect);
-    }
+    m_texture.planes[0]->update(*view.image(), region);
 }
 
 bool BasicEGLSurfaceTextureWayland::loadDmabufTexture(GraphicsBuffer *buffer)
@@ -204,11 +204,21 @@ void BlurEffect::reconfigure(ReconfigureFlags flags)
     m_offset = blurStrengthValues[blurStrength].offset;
     m_expandSize = blurOffsets[m_iterationCount - 1].expandSize;
     m_noiseStrength = BlurConfig::noiseStrength();
+    invalidateCache();
 
     // Update all windows for the blur to take effect
     effects->addRepaintFull();
 }
 
+void BlurEffect::invalidateCache()
+{
+    for (auto &[window, data] : m_windows) {
+        for (auto &[screen, renderInfo] : data.render) {
+            renderInfo.cached = false;
+        }
+    }
+}
+
 void BlurEffect::updateBlurRegion(EffectWindow *w)
 {
     QRegion region;
@@ -433,6 +443,16 @@ void BlurEffect::prePaintWindow(EffectWindow *w, WindowPrePaintData &data, std::
     // in case this window has regions to be blurred
     const QRegion blurArea = blurRegion(w).boundingRect().translated(w->pos().toPoint());
 
+    // if a window underneath the blurred area is painted again, the cached blurred
+    // background is outdated
+    if (m_paintedArea.intersects(blurArea)) {
+        if (auto it = m_windows.find(w); it != m_windows.end()) {
+            if (auto renderIt = it->second.render.find(m_currentScreen); renderIt != it->second.render.end()) {
+                renderIt->second.cached = false;
+            }
+        }
+    }
+
     // if this window or a window underneath the blurred area is painted again we have to
     // blur everything
     if (m_paintedArea.intersects(blurArea) || data.paint.intersects(blurArea)) {
@@ -571,6 +591,7 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
     if (renderInfo.framebuffers.size() != (m_iterationCount + 1) || renderInfo.textures[0]->size() != backgroundRect.size() || renderInfo.textures[0]->internalFormat() != textureFormat) {
         renderInfo.framebuffers.clear();
         renderInfo.textures.clear();
+        renderInfo.cached = false;
 
         for (size_t i = 0; i <= m_iterationCount; ++i) {
             auto texture = GLTexture::allocate(textureFormat, backgroundRect.size() / (1 << i));
@@ -591,10 +612,17 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
         }
     }
 
+    // The blurred background can be reused if nothing behind the window has changed. The cache
+    // is not used for transformed windows because the damage tracking doesn't account for that.
+    const bool cacheable = data.xScale() == 1 && data.yScale() == 1 && !data.xTranslation() && !data.yTranslation();
+    const bool useCache = cacheable && renderInfo.cached && renderInfo.cachedRect == backgroundRect && renderInfo.cachedScale == viewport.scale();
+
     // Fetch the pixels behind the shape that is going to be blurred.
-    const QRegion dirtyRegion = region & backgroundRect;
-    for (const QRect &dirtyRect : dirtyRegion) {
-        renderInfo.framebuffers[0]->blitFromRenderTarget(renderTarget, viewport, dirtyRect, dirtyRect.translated(-backgroundRect.topLeft()));
+    if (!useCache) {
+        const QRegion dirtyRegion = region & backgroundRect;
+        for (const QRect &dirtyRect : dirtyRegion) {
+            renderInfo.framebuffers[0]->blitFromRenderTarget(renderTarget, viewport, dirtyRect, dirtyRect.translated(-backgroundRect.topLeft()));
+        }
     }
 
     // Upload the geometry: the first 6 vertices are used when downsampling and upsampling offscreen,
@@ -704,7 +732,7 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
     vbo->bindArrays();
 
     // The downsample pass of the dual Kawase algorithm: the background will be scaled down 50% every iteration.
-    {
+    if (!useCache) {
         ShaderManager::instance()->pushShader(m_downsamplePass.shader.get());
 
         QMatrix4x4 projectionMatrix;
@@ -740,21 +768,29 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
         m_upsamplePass.shader->setUniform(m_upsamplePass.mvpMatrixLocation, projectionMatrix);
         m_upsamplePass.shader->setUniform(m_upsamplePass.offsetLocation, float(m_offset));
 
-        for (size_t i = renderInfo.framebuffers.size() - 1; i > 1; --i) {
-            GLFramebuffer::popFramebuffer();
-            const auto &read = renderInfo.framebuffers[i];
+        if (!useCache) {
+            for (size_t i = renderInfo.framebuffers.size() - 1; i > 1; --i) {
+                GLFramebuffer::popFramebuffer();
+                const auto &read = renderInfo.framebuffers[i];
 
-            const QVector2D halfpixel(0.5 / read->colorAttachment()->width(),
-                                      0.5 / read->colorAttachment()->height());
-            m_upsamplePass.shader->setUniform(m_upsamplePass.halfpixelLocation, halfpixel);
+                const QVector2D halfpixel(0.5 / read->colorAttachment()->width(),
+                                          0.5 / read->colorAttachment()->height());
+                m_upsamplePass.shader->setUniform(m_upsamplePass.halfpixelLocation, halfpixel);
 
-            read->colorAttachment()->bind();
+                read->colorAttachment()->bind();
 
-            vbo->draw(GL_TRIANGLES, 0, 6);
+                vbo->draw(GL_TRIANGLES, 0, 6);
+            }
+
+            GLFramebuffer::popFramebuffer();
+
+            renderInfo.cached = cacheable;
+            renderInfo.cachedRect = backgroundRect;
+            renderInfo.cachedScale = viewport.scale();
         }
 
-        // The last upsampling pass is rendered on the screen, not in framebuffers[0].
-        GLFramebuffer::popFramebuffer();
+        // The last upsampling pass is rendered on the screen, not in framebuffers[0]. Its input,
+        // framebuffers[1], is what gets reused when the blurred background is cached.
         const auto &read = renderInfo.framebuffers[1];
 
         projectionMatrix = data.projectionMatrix();
@@ -25,6 +25,13 @@ struct BlurRenderData
     /// contains not blurred background behind the window, it's cached.
     std::vector<std::unique_ptr<GLTexture>> textures;
     std::vector<std::unique_ptr<GLFramebuffer>> framebuffers;
+
+    /// Whether textures[1] still contains the blurred background from the last frame. If the
+    /// background behind the window hasn't changed since then, only the final upsample pass
+    /// needs to be rendered.
+    bool cached = false;
+    QRect cachedRect;
+    qreal cachedScale = 1.0;
 };
 
 struct BlurEffectData
@@ -78,6 +85,7 @@ private:
     bool decorationSupportsBlurBehind(const EffectWindow *w) const;
     bool shouldBlur(const EffectWindow *w, int mask, const WindowPaintData &data) const;
     void updateBlurRegion(EffectWindow *w);
+    void invalidateCache();
     void blur(const RenderTarget &renderTarget, const RenderViewport &viewport, EffectWindow *w, int mask, const QRegion &region, WindowPaintData &data);
     GLTexture *ensureNoiseTexture();
 
@@ -192,7 +192,7 @@ void ScreencastManager::streamRegion(ScreencastStreamV1Interface *waylandStream,
                     const QRect streamRegion = source->region();
                     const QRegion region = output->pixelSize() != output->modeSize() ? output->geometry() : damagedRegion;
                     source->updateOutput(output);
-                    stream->recordFrame(scaleRegion(region.translated(-streamRegion.topLeft()).intersected(streamRegion), source->scale()));
+                    stream->recordFrame(scaleRegion(region.intersected(streamRegion).translated(-streamRegion.topLeft()), source->scale()));
                 };
                 connect(output, &Output::outputChange, stream, bufferToStream);
                 found |= true;
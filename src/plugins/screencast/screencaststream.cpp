@@ -31,6 +31,7 @@
 
 #include <spa/buffer/meta.h>
 
+#include <algorithm>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
@@ -40,6 +41,8 @@
 namespace KWin
 {
 
+static constexpr size_t s_maxCachedCursorTextures = 8;
+
 static spa_video_format drmFourCCToSpaVideoFormat(quint32 format)
 {
     switch (format) {
@@ -458,13 +461,25 @@ void ScreenCastStream::recordFrame(const QRegion &_damagedRegion)
         return;
     }
 
-    if (m_videoFormat.max_framerate.num != 0 && !m_lastSent.isNull()) {
-        auto frameInterval = (1000. * m_videoFormat.max_framerate.denom / m_videoFormat.max_framerate.num);
-        auto lastSentAgo = m_lastSent.msecsTo(QDateTime::currentDateTimeUtc());
+    // Nothing has changed in the captured area, e.g. the damage was outside of the captured
+    // region or only the cursor moved somewhere else, so there's no need to produce a frame
+    if (damagedRegion.isEmpty()) {
+        if (m_cursor.mode != ScreencastV1Interface::Embedded) {
+            return;
+        }
+        const QRectF cursorRect = embeddedCursorRect();
+        if (cursorRect == m_cursor.lastRect && (cursorRect.isEmpty() || !m_cursor.changed)) {
+            return;
+        }
+    }
+
+    if (m_videoFormat.max_framerate.num != 0 && m_lastSent) {
+        const auto frameInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(double(m_videoFormat.max_framerate.denom) / m_videoFormat.max_framerate.num));
+        const auto lastSentAgo = std::chrono::steady_clock::now() - *m_lastSent;
         if (lastSentAgo < frameInterval) {
             m_pendingDamages |= damagedRegion;
             if (!m_pendingFrame.isActive()) {
-                m_pendingFrame.start(frameInterval - lastSentAgo);
+                m_pendingFrame.start(std::chrono::ceil<std::chrono::milliseconds>(frameInterval - lastSentAgo));
             }
             return;
         }
@@ -540,6 +555,14 @@ void ScreenCastStream::recordFrame(const QRegion &_damagedRegion)
             const auto position = (cursor->pos() - m_cursor.viewport.topLeft() - cursor->hotspot()) * m_cursor.scale;
             const PlatformCursorImage cursorImage = kwinApp()->cursorImage();
             painter.drawImage(QRect{position.toPoint(), cursorImage.image().size()}, cursorImage.image());
+
+            const QRectF cursorRect = embeddedCursorRect();
+            damagedRegion += QRegion{m_cursor.lastRect.toAlignedRect()} | cursorRect.toAlignedRect();
+            m_cursor.lastRect = cursorRect;
+            m_cursor.changed = false;
+        } else if (m_cursor.mode == ScreencastV1Interface::Embedded) {
+            damagedRegion |= m_cursor.lastRect.toAlignedRect();
+            m_cursor.lastRect = {};
         }
     } else {
         auto &buf = m_dmabufDataForPwBuffer[buffer];
@@ -557,21 +580,12 @@ void ScreenCastStream::recordFrame(const QRegion &_damagedRegion)
 
         auto cursor = Cursors::self()->currentCursor();
         if (m_cursor.mode == ScreencastV1Interface::Embedded && exclusiveContains(m_cursor.viewport, cursor->pos())) {
-            if (m_cursor.invalid) {
-                m_cursor.invalid = false;
-                const PlatformCursorImage cursorImage = kwinApp()->cursorImage();
-                if (cursorImage.isNull()) {
-                    m_cursor.texture = nullptr;
-                } else {
-                    m_cursor.texture = GLTexture::upload(cursorImage.image());
-                }
-            }
-            if (m_cursor.texture) {
+            if (GLTexture *texture = embeddedCursorTexture()) {
                 GLFramebuffer::pushFramebuffer(buf->framebuffer());
 
                 auto shader = ShaderManager::instance()->pushShader(ShaderTrait::MapTexture);
 
-                const QRectF cursorRect = scaledRect(cursor->geometry().translated(-m_cursor.viewport.topLeft()), m_cursor.scale);
+                const QRectF cursorRect = embeddedCursorRect();
                 QMatrix4x4 mvp;
                 mvp.scale(1, -1);
                 mvp.ortho(QRectF(QPointF(0, 0), size));
@@ -580,7 +594,7 @@ void ScreenCastStream::recordFrame(const QRegion &_damagedRegion)
 
                 glEnable(GL_BLEND);
                 glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-                m_cursor.texture->render(cursorRect.size());
+                texture->render(cursorRect.size());
                 glDisable(GL_BLEND);
 
                 ShaderManager::instance()->popShader();
@@ -588,10 +602,15 @@ void ScreenCastStream::recordFrame(const QRegion &_damagedRegion)
 
                 damagedRegion += QRegion{m_cursor.lastRect.toAlignedRect()} | cursorRect.toAlignedRect();
                 m_cursor.lastRect = cursorRect;
+                m_cursor.changed = false;
             } else {
                 damagedRegion |= m_cursor.lastRect.toAlignedRect();
                 m_cursor.lastRect = {};
+                m_cursor.changed = false;
             }
+        } else if (m_cursor.mode == ScreencastV1Interface::Embedded) {
+            damagedRegion |= m_cursor.lastRect.toAlignedRect();
+            m_cursor.lastRect = {};
         }
     }
 
@@ -646,6 +665,58 @@ void ScreenCastStream::addDamage(spa_buffer *spaBuffer, const QRegion &damagedRe
 void ScreenCastStream::invalidateCursor()
 {
     m_cursor.invalid = true;
+    m_cursor.changed = true;
+}
+
+QRectF ScreenCastStream::embeddedCursorRect() const
+{
+    const Cursor *cursor = Cursors::self()->currentCursor();
+    if (!exclusiveContains(m_cursor.viewport, cursor->pos())) {
+        return QRectF();
+    }
+    return scaledRect(cursor->geometry().translated(-m_cursor.viewport.topLeft()), m_cursor.scale);
+}
+
+GLTexture *ScreenCastStream::embeddedCursorTexture()
+{
+    if (!m_cursor.invalid) {
+        return m_cursor.texture;
+    }
+    m_cursor.invalid = false;
+    m_cursor.texture = nullptr;
+
+    const PlatformCursorImage cursorImage = kwinApp()->cursorImage();
+    if (cursorImage.isNull()) {
+        return nullptr;
+    }
+
+    // Animated cursors and applications switching between a handful of cursors show the
+    // same images over and over again, keep the textures around instead of uploading them
+    // every time the cursor changes
+    const QImage image = cursorImage.image();
+    const size_t key = qHashMulti(0, image.width(), image.height(), int(image.format()), QByteArrayView(image.constBits(), image.sizeInBytes()));
+    auto it = std::find_if(m_cursorTextures.begin(), m_cursorTextures.end(), [&key, &image](const CachedCursorTexture &cached) {
+        return cached.key == key && cached.image == image;
+    });
+    if (it != m_cursorTextures.end()) {
+        std::rotate(m_cursorTextures.begin(), it, it + 1);
+    } else {
+        auto texture = GLTexture::upload(image);
+        if (!texture) {
+            return nullptr;
+        }
+        if (m_cursorTextures.size() >= s_maxCachedCursorTextures) {
+            m_cursorTextures.pop_back();
+        }
+        m_cursorTextures.insert(m_cursorTextures.begin(), CachedCursorTexture{
+                                                              .key = key,
+                                                              .image = image,
+                                                              .texture = std::move(texture),
+                                                          });
+    }
+
+    m_cursor.texture = m_cursorTextures.front().texture.get();
+    return m_cursor.texture;
 }
 
 void ScreenCastStream::recordCursor()
@@ -730,7 +801,7 @@ void ScreenCastStream::enqueue()
     pw_stream_queue_buffer(m_pwStream, m_pendingBuffer);
 
     if (m_pendingBuffer->buffer->datas[0].chunk->flags != SPA_CHUNK_FLAG_CORRUPTED) {
-        m_lastSent = QDateTime::currentDateTimeUtc();
+        m_lastSent = std::chrono::steady_clock::now();
     }
 
     m_pendingBuffer = nullptr;
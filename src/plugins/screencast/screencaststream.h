@@ -12,8 +12,8 @@
 
 #include "wayland/screencast_v1.h"
 
-#include <QDateTime>
 #include <QHash>
+#include <QImage>
 #include <QObject>
 #include <QRegion>
 #include <QSocketNotifier>
@@ -21,6 +21,7 @@
 #include <chrono>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include <pipewire/pipewire.h>
 #include <spa/param/format-utils.h>
@@ -97,6 +98,8 @@ private:
     void newStreamParams();
     void tryEnqueue(pw_buffer *buffer);
     void enqueue();
+    QRectF embeddedCursorRect() const;
+    GLTexture *embeddedCursorTexture();
     spa_pod *buildFormat(struct spa_pod_builder *b, enum spa_video_format format, struct spa_rectangle *resolution,
                          struct spa_fraction *defaultFramerate, struct spa_fraction *minFramerate, struct spa_fraction *maxFramerate,
                          const QList<uint64_t> &modifiers, quint32 modifiersFlags);
@@ -129,11 +132,21 @@ private:
         qreal scale = 1;
         QRectF viewport;
         QRectF lastRect;
-        std::unique_ptr<GLTexture> texture;
+        GLTexture *texture = nullptr;
         bool visible = false;
         bool invalid = true;
+        bool changed = true;
     } m_cursor;
 
+    struct CachedCursorTexture
+    {
+        size_t key;
+        QImage image;
+        std::unique_ptr<GLTexture> texture;
+    };
+    // Most recently used first
+    std::vector<CachedCursorTexture> m_cursorTextures;
+
     QHash<struct pw_buffer *, std::shared_ptr<ScreenCastDmaBufTexture>> m_dmabufDataForPwBuffer;
 
     pw_buffer *m_pendingBuffer = nullptr;
@@ -144,7 +157,7 @@ private:
     bool m_waitForNewBuffers = false;
     quint32 m_drmFormat = 0;
 
-    QDateTime m_lastSent;
+    std::optional<std::chrono::steady_clock::time_point> m_lastSent;
     QRegion m_pendingDamages;
     QTimer m_pendingFrame;
 };
@@ -10,6 +10,7 @@
 */
 #include "screenshot.h"
 #include "screenshotdbusinterface2.h"
+#include "screenshotlogging.h"
 
 #include "core/output.h"
 #include "core/rendertarget.h"
@@ -19,6 +20,10 @@
 #include "opengl/glutils.h"
 
 #include <QPainter>
+#include <QtConcurrentRun>
+
+#include <cstring>
+#include <optional>
 
 namespace KWin
 {
@@ -37,6 +42,8 @@ struct ScreenShotAreaData
     QRect area;
     QImage result;
     QList<Output *> screens;
+    QList<QRect> sourceRects;
+    QList<QFuture<QImage>> snapshots;
 };
 
 struct ScreenShotScreenData
@@ -46,6 +53,70 @@ struct ScreenShotScreenData
     Output *screen = nullptr;
 };
 
+/**
+ * The pixels are copied into a pixel pack buffer, and fetched from it only after the GPU is done
+ * with the copy so the compositor doesn't have to wait for the GPU while painting a frame.
+ */
+struct ScreenShotReadback
+{
+    ~ScreenShotReadback();
+
+    GLuint buffer = 0;
+    GLsync sync = nullptr;
+    const void *data = nullptr;
+    QSize size;
+    QMatrix4x4 renderTargetTransformation;
+    qreal devicePixelRatio = 1.0;
+    QPromise<QImage> promise;
+    QFuture<void> conversion;
+};
+
+struct ScreenShotPointer
+{
+    QImage image;
+    QPointF position;
+};
+
+static std::optional<ScreenShotPointer> grabPointer(ScreenShotFlags flags)
+{
+    if (!(flags & ScreenShotIncludeCursor) || effects->isCursorHidden()) {
+        return std::nullopt;
+    }
+
+    const PlatformCursorImage cursor = effects->cursorImage();
+    if (cursor.image().isNull()) {
+        return std::nullopt;
+    }
+
+    return ScreenShotPointer{
+        .image = cursor.image(),
+        .position = effects->cursorPos() - cursor.hotSpot(),
+    };
+}
+
+static void drawPointer(QImage &snapshot, const ScreenShotPointer &pointer, const QPoint &offset)
+{
+    QPainter painter(&snapshot);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(pointer.position - offset, pointer.image);
+}
+
+/**
+ * Fulfills the @a promise with the @a snapshot once it's available, the pointer is drawn on top
+ * of the image if requested. If the snapshot gets cancelled, so does the promise.
+ */
+static void resolveScreenShot(QObject *context, QPromise<QImage> &&promise, QFuture<QImage> snapshot, const std::optional<ScreenShotPointer> &pointer, const QPoint &offset)
+{
+    auto sharedPromise = std::make_shared<QPromise<QImage>>(std::move(promise));
+    snapshot.then(context, [sharedPromise, pointer, offset](QImage image) {
+        if (pointer) {
+            drawPointer(image, *pointer, offset);
+        }
+        sharedPromise->addResult(image);
+        sharedPromise->finish();
+    });
+}
+
 static void convertFromGLImage(QImage &img, int w, int h, const QMatrix4x4 &renderTargetTransformation)
 {
     // from QtOpenGL/qgl.cpp
@@ -82,6 +153,36 @@ static void convertFromGLImage(QImage &img, int w, int h, const QMatrix4x4 &rend
     img = img.transformed(matrix.toTransform());
 }
 
+static bool supportsAsyncReadback()
+{
+    if (qgetenv("KWIN_SCREENSHOT_ASYNC_READBACK") == QByteArrayLiteral("0")) {
+        return false;
+    }
+    if (GLPlatform::instance()->isGLES()) {
+        return hasGLVersion(3, 0);
+    } else {
+        const bool haveMapBufferRange = hasGLVersion(3, 0) || hasGLExtension(QByteArrayLiteral("GL_ARB_map_buffer_range"));
+        const bool haveSyncFences = hasGLVersion(3, 2) || hasGLExtension(QByteArrayLiteral("GL_ARB_sync"));
+        const bool havePixelBufferObjects = hasGLVersion(2, 1) || hasGLExtension(QByteArrayLiteral("GL_ARB_pixel_buffer_object"));
+        return haveMapBufferRange && haveSyncFences && havePixelBufferObjects;
+    }
+}
+
+ScreenShotReadback::~ScreenShotReadback()
+{
+    // The conversion reads the mapped buffer, it must be done before the buffer is unmapped
+    if (data) {
+        conversion.waitForFinished();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    if (sync) {
+        glDeleteSync(sync);
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
 bool ScreenShotEffect::supported()
 {
     return effects->isOpenGLCompositing() && GLFramebuffer::supported();
@@ -93,6 +194,10 @@ ScreenShotEffect::ScreenShotEffect()
     connect(effects, &EffectsHandler::screenAdded, this, &ScreenShotEffect::handleScreenAdded);
     connect(effects, &EffectsHandler::screenRemoved, this, &ScreenShotEffect::handleScreenRemoved);
     connect(effects, &EffectsHandler::windowClosed, this, &ScreenShotEffect::handleWindowClosed);
+
+    m_readbackTimer.setSingleShot(true);
+    m_readbackTimer.setInterval(std::chrono::milliseconds(5));
+    connect(&m_readbackTimer, &QTimer::timeout, this, &ScreenShotEffect::processReadbacks);
 }
 
 ScreenShotEffect::~ScreenShotEffect()
@@ -100,6 +205,11 @@ ScreenShotEffect::~ScreenShotEffect()
     cancelWindowScreenShots();
     cancelAreaScreenShots();
     cancelScreenScreenShots();
+
+    if (!m_readbacks.empty()) {
+        effects->makeOpenGLContextCurrent();
+        m_readbacks.clear();
+    }
 }
 
 QFuture<QImage> ScreenShotEffect::scheduleScreenShot(Output *screen, ScreenShotFlags flags)
@@ -262,7 +372,7 @@ void ScreenShotEffect::takeScreenShot(ScreenShotWindowData *screenshot)
 
         // render window into offscreen texture
         int mask = PAINT_WINDOW_TRANSFORMED | PAINT_WINDOW_TRANSLUCENT;
-        QImage img;
+        QFuture<QImage> snapshot;
         if (effects->isOpenGLCompositing()) {
             RenderTarget renderTarget(target.get());
             RenderViewport viewport(geometry, devicePixelRatio, renderTarget);
@@ -278,20 +388,13 @@ void ScreenShotEffect::takeScreenShot(ScreenShotWindowData *screenshot)
             effects->drawWindow(renderTarget, viewport, window, mask, infiniteRegion(), d);
 
             // copy content from framebuffer into image
-            img = QImage(offscreenTexture->size(), QImage::Format_ARGB32);
-            img.setDevicePixelRatio(devicePixelRatio);
-            glReadnPixels(0, 0, img.width(), img.height(), GL_RGBA, GL_UNSIGNED_BYTE, img.sizeInBytes(),
-                          static_cast<GLvoid *>(img.bits()));
+            snapshot = readPixels(offscreenTexture->size(), renderTarget.transformation(), devicePixelRatio);
             GLFramebuffer::popFramebuffer();
-            convertFromGLImage(img, img.width(), img.height(), renderTarget.transformation());
-        }
-
-        if (screenshot->flags & ScreenShotIncludeCursor) {
-            grabPointerImage(img, geometry.x(), geometry.y());
+        } else {
+            snapshot = QtFuture::makeReadyValueFuture(QImage());
         }
 
-        screenshot->promise.addResult(img);
-        screenshot->promise.finish();
+        resolveScreenShot(this, std::move(screenshot->promise), snapshot, grabPointer(screenshot->flags), QPoint(geometry.x(), geometry.y()));
     }
 }
 
@@ -299,12 +402,8 @@ bool ScreenShotEffect::takeScreenShot(const RenderTarget &renderTarget, const Re
 {
     if (!effects->waylandDisplay()) {
         // On X11, all screens are painted simultaneously and there is no native HiDPI support.
-        QImage snapshot = blitScreenshot(renderTarget, viewport, screenshot->area);
-        if (screenshot->flags & ScreenShotIncludeCursor) {
-            grabPointerImage(snapshot, screenshot->area.x(), screenshot->area.y());
-        }
-        screenshot->promise.addResult(snapshot);
-        screenshot->promise.finish();
+        const QFuture<QImage> snapshot = blitScreenshot(renderTarget, viewport, screenshot->area);
+        resolveScreenShot(this, std::move(screenshot->promise), snapshot, grabPointer(screenshot->flags), screenshot->area.topLeft());
         return true;
     } else {
         if (!screenshot->screens.contains(m_paintedScreen)) {
@@ -318,21 +417,33 @@ bool ScreenShotEffect::takeScreenShot(const RenderTarget &renderTarget, const Re
             sourceDevicePixelRatio = m_paintedScreen->scale();
         }
 
-        const QImage snapshot = blitScreenshot(renderTarget, viewport, sourceRect, sourceDevicePixelRatio);
-        const QRect nativeArea(screenshot->area.topLeft(),
-                               screenshot->area.size() * screenshot->result.devicePixelRatio());
-
-        QPainter painter(&screenshot->result);
-        painter.setWindow(nativeArea);
-        painter.drawImage(sourceRect, snapshot);
-        painter.end();
+        screenshot->sourceRects.append(sourceRect);
+        screenshot->snapshots.append(blitScreenshot(renderTarget, viewport, sourceRect, sourceDevicePixelRatio));
 
         if (screenshot->screens.isEmpty()) {
-            if (screenshot->flags & ScreenShotIncludeCursor) {
-                grabPointerImage(screenshot->result, screenshot->area.x(), screenshot->area.y());
-            }
-            screenshot->promise.addResult(screenshot->result);
-            screenshot->promise.finish();
+            // The snapshots of the screens may become available later, assemble the final image then
+            auto data = std::make_shared<ScreenShotAreaData>(std::move(*screenshot));
+            const std::optional<ScreenShotPointer> pointer = grabPointer(data->flags);
+            QtFuture::whenAll(data->snapshots.begin(), data->snapshots.end()).then(this, [data, pointer](const QList<QFuture<QImage>> &snapshots) {
+                const QRect nativeArea(data->area.topLeft(),
+                                       data->area.size() * data->result.devicePixelRatio());
+
+                QPainter painter(&data->result);
+                painter.setWindow(nativeArea);
+                for (int i = 0; i < snapshots.size(); ++i) {
+                    if (snapshots[i].isCanceled()) {
+                        return;
+                    }
+                    painter.drawImage(data->sourceRects[i], snapshots[i].result());
+                }
+                painter.end();
+
+                if (pointer) {
+                    drawPointer(data->result, *pointer, data->area.topLeft());
+                }
+                data->promise.addResult(data->result);
+                data->promise.finish();
+            });
             return true;
         }
     }
@@ -351,31 +462,23 @@ bool ScreenShotEffect::takeScreenShot(const RenderTarget &renderTarget, const Re
         devicePixelRatio = screenshot->screen->scale();
     }
 
-    QImage snapshot = blitScreenshot(renderTarget, viewport, screenshot->screen->geometry(), devicePixelRatio);
-    if (screenshot->flags & ScreenShotIncludeCursor) {
-        const int xOffset = screenshot->screen->geometry().x();
-        const int yOffset = screenshot->screen->geometry().y();
-        grabPointerImage(snapshot, xOffset, yOffset);
-    }
-
-    screenshot->promise.addResult(snapshot);
-    screenshot->promise.finish();
+    const QFuture<QImage> snapshot = blitScreenshot(renderTarget, viewport, screenshot->screen->geometry(), devicePixelRatio);
+    resolveScreenShot(this, std::move(screenshot->promise), snapshot, grabPointer(screenshot->flags), screenshot->screen->geometry().topLeft());
 
     return true;
 }
 
-QImage ScreenShotEffect::blitScreenshot(const RenderTarget &renderTarget, const RenderViewport &viewport, const QRect &geometry, qreal devicePixelRatio) const
+QFuture<QImage> ScreenShotEffect::blitScreenshot(const RenderTarget &renderTarget, const RenderViewport &viewport, const QRect &geometry, qreal devicePixelRatio)
 {
-    QImage image;
+    QFuture<QImage> snapshot;
 
     if (effects->isOpenGLCompositing()) {
         const auto screenGeometry = m_paintedScreen ? m_paintedScreen->geometry() : effects->virtualScreenGeometry();
         const QSize nativeSize = renderTarget.applyTransformation(geometry, screenGeometry).size() * devicePixelRatio;
-        image = QImage(nativeSize, QImage::Format_ARGB32);
 
         const auto texture = GLTexture::allocate(GL_RGBA8, nativeSize);
         if (!texture) {
-            return {};
+            return QtFuture::makeReadyValueFuture(QImage());
         }
         GLFramebuffer target(texture.get());
         if (renderTarget.texture()) {
@@ -390,30 +493,111 @@ QImage ScreenShotEffect::blitScreenshot(const RenderTarget &renderTarget, const
             target.blitFromFramebuffer(viewport.mapToRenderTarget(geometry));
             GLFramebuffer::pushFramebuffer(&target);
         }
-        glReadPixels(0, 0, nativeSize.width(), nativeSize.height(), GL_RGBA,
-                     GL_UNSIGNED_BYTE, static_cast<GLvoid *>(image.bits()));
+        snapshot = readPixels(nativeSize, renderTarget.transformation(), devicePixelRatio);
         GLFramebuffer::popFramebuffer();
-        convertFromGLImage(image, nativeSize.width(), nativeSize.height(), renderTarget.transformation());
+    } else {
+        QImage image;
+        image.setDevicePixelRatio(devicePixelRatio);
+        snapshot = QtFuture::makeReadyValueFuture(image);
     }
 
-    image.setDevicePixelRatio(devicePixelRatio);
-    return image;
+    return snapshot;
 }
 
-void ScreenShotEffect::grabPointerImage(QImage &snapshot, int xOffset, int yOffset) const
+QFuture<QImage> ScreenShotEffect::readPixels(const QSize &size, const QMatrix4x4 &renderTargetTransformation, qreal devicePixelRatio)
 {
-    if (effects->isCursorHidden()) {
-        return;
+    if (!supportsAsyncReadback()) {
+        QImage image(size, QImage::Format_ARGB32);
+        glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, static_cast<GLvoid *>(image.bits()));
+        convertFromGLImage(image, size.width(), size.height(), renderTargetTransformation);
+        image.setDevicePixelRatio(devicePixelRatio);
+        return QtFuture::makeReadyValueFuture(image);
     }
 
-    const PlatformCursorImage cursor = effects->cursorImage();
-    if (cursor.image().isNull()) {
+    auto readback = std::make_unique<ScreenShotReadback>();
+    readback->size = size;
+    readback->renderTargetTransformation = renderTargetTransformation;
+    readback->devicePixelRatio = devicePixelRatio;
+
+    glGenBuffers(1, &readback->buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size.width() * size.height() * 4, nullptr, GL_STREAM_READ);
+    glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback->sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (!readback->sync) {
+        qCWarning(KWIN_SCREENSHOT) << "Failed to create a fence for the screenshot readback";
+        glFinish();
+    }
+
+    readback->promise.start();
+    QFuture<QImage> future = readback->promise.future();
+
+    m_readbacks.push_back(std::move(readback));
+    if (!m_readbackTimer.isActive()) {
+        m_readbackTimer.start();
+    }
+
+    return future;
+}
+
+void ScreenShotEffect::processReadbacks()
+{
+    if (!effects->makeOpenGLContextCurrent()) {
+        m_readbackTimer.start();
         return;
     }
 
-    QPainter painter(&snapshot);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform);
-    painter.drawImage(effects->cursorPos() - cursor.hotSpot() - QPoint(xOffset, yOffset), cursor.image());
+    for (auto it = m_readbacks.begin(); it != m_readbacks.end();) {
+        ScreenShotReadback *readback = it->get();
+
+        if (readback->data) {
+            if (readback->conversion.isFinished()) {
+                it = m_readbacks.erase(it);
+            } else {
+                ++it;
+            }
+            continue;
+        }
+
+        if (readback->sync) {
+            GLint status;
+            glGetSynciv(readback->sync, GL_SYNC_STATUS, 1, nullptr, &status);
+            if (status != GL_SIGNALED) {
+                ++it;
+                continue;
+            }
+            glDeleteSync(readback->sync);
+            readback->sync = nullptr;
+        }
+
+        const qsizetype byteCount = readback->size.width() * readback->size.height() * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+        readback->data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, byteCount, GL_MAP_READ_BIT);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!readback->data) {
+            qCWarning(KWIN_SCREENSHOT) << "Failed to map the screenshot pixel pack buffer";
+            it = m_readbacks.erase(it);
+            continue;
+        }
+
+        // Converting a large screenshot takes a while, don't block the compositor while doing it
+        readback->conversion = QtConcurrent::run([readback, byteCount]() {
+            QImage image(readback->size, QImage::Format_ARGB32);
+            std::memcpy(image.bits(), readback->data, byteCount);
+            convertFromGLImage(image, image.width(), image.height(), readback->renderTargetTransformation);
+            image.setDevicePixelRatio(readback->devicePixelRatio);
+
+            readback->promise.addResult(image);
+            readback->promise.finish();
+        });
+        ++it;
+    }
+
+    if (!m_readbacks.empty()) {
+        m_readbackTimer.start();
+    }
 }
 
 bool ScreenShotEffect::isActive() const
@@ -15,6 +15,9 @@
 #include <QFuture>
 #include <QImage>
 #include <QObject>
+#include <QTimer>
+
+#include <memory>
 
 namespace KWin
 {
@@ -34,6 +37,7 @@ class ScreenShotDBusInterface2;
 struct ScreenShotWindowData;
 struct ScreenShotAreaData;
 struct ScreenShotScreenData;
+struct ScreenShotReadback;
 
 /**
  * The ScreenShotEffect provides a convenient way to capture the contents of a given window,
@@ -91,13 +95,17 @@ private:
     void cancelAreaScreenShots();
     void cancelScreenScreenShots();
 
-    void grabPointerImage(QImage &snapshot, int xOffset, int yOffset) const;
-    QImage blitScreenshot(const RenderTarget &renderTarget, const RenderViewport &viewport, const QRect &geometry, qreal devicePixelRatio = 1.0) const;
+    QFuture<QImage> blitScreenshot(const RenderTarget &renderTarget, const RenderViewport &viewport, const QRect &geometry, qreal devicePixelRatio = 1.0);
+    QFuture<QImage> readPixels(const QSize &size, const QMatrix4x4 &renderTargetTransformation, qreal devicePixelRatio);
+    void processReadbacks();
 
     std::vector<ScreenShotWindowData> m_windowScreenShots;
     std::vector<ScreenShotAreaData> m_areaScreenShots;
     std::vector<ScreenShotScreenData> m_screenScreenShots;
 
+    std::vector<std::unique_ptr<ScreenShotReadback>> m_readbacks;
+    QTimer m_readbackTimer;
+
     std::unique_ptr<ScreenShotDBusInterface2> m_dbusInterface2;
     Output *m_paintedScreen = nullptr;
 };
@@ -0,0 +1,294 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "wobblymesh.h"
+#include "scene/itemgeometry.h"
+
+#include <cmath>
+#include <limits>
+
+namespace KWin
+{
+
+static constexpr std::array<float, WobblyMesh::Count> makeSpringWeights()
+{
+    std::array<float, WobblyMesh::Count> weights;
+    for (int row = 0; row < WobblyMesh::Height; ++row) {
+        for (int column = 0; column < WobblyMesh::Width; ++column) {
+            const int springs = (row > 0) + (row < WobblyMesh::Height - 1) + (column > 0) + (column < WobblyMesh::Width - 1);
+            weights[row * WobblyMesh::Width + column] = 1.0f / springs;
+        }
+    }
+    return weights;
+}
+
+static constexpr std::array<float, WobblyMesh::Count> makeRingWeights()
+{
+    std::array<float, WobblyMesh::Count> weights;
+    for (int row = 0; row < WobblyMesh::Height; ++row) {
+        for (int column = 0; column < WobblyMesh::Width; ++column) {
+            const int rows = 1 + (row > 0) + (row < WobblyMesh::Height - 1);
+            const int columns = 1 + (column > 0) + (column < WobblyMesh::Width - 1);
+            const int neighbours = rows * columns - 1;
+            weights[row * WobblyMesh::Width + column] = 1.0f / (2 * neighbours);
+        }
+    }
+    return weights;
+}
+
+// The spring forces are averaged over the springs attached to a point
+static constexpr std::array<float, WobblyMesh::Count> s_springWeights = makeSpringWeights();
+// A point weighs as much as all of its neighbours together when smoothing
+static constexpr std::array<float, WobblyMesh::Count> s_ringWeights = makeRingWeights();
+
+static inline float clampMagnitude(float value, float min, float max)
+{
+    const float magnitude = std::abs(value);
+    if (magnitude < min) {
+        return 0.0f;
+    } else if (magnitude > max) {
+        return std::copysign(max, value);
+    }
+    return value;
+}
+
+static inline std::array<float, 4> bernstein(float t)
+{
+    const float s = 1.0f - t;
+    return {s * s * s, 3.0f * s * s * t, 3.0f * s * t * t, t * t * t};
+}
+
+void WobblyMesh::reset(const QRectF &geometry)
+{
+    m_anchor = geometry.topLeft();
+    updateOrigin(geometry.size());
+    m_position = m_origin;
+    m_velocity = {};
+    m_acceleration = {};
+    m_constraint.fill(false);
+}
+
+void WobblyMesh::setConstrained(int index, bool constrained)
+{
+    m_constraint[index] = constrained;
+}
+
+void WobblyMesh::setVelocity(int index, const QPointF &velocity)
+{
+    m_velocity.x[index] = velocity.x();
+    m_velocity.y[index] = velocity.y();
+}
+
+void WobblyMesh::moveAnchor(const QPointF &anchor)
+{
+    if (anchor == m_anchor) {
+        return;
+    }
+    const float dx = m_anchor.x() - anchor.x();
+    const float dy = m_anchor.y() - anchor.y();
+    for (int i = 0; i < Count; ++i) {
+        m_position.x[i] += dx;
+        m_position.y[i] += dy;
+    }
+    m_anchor = anchor;
+}
+
+void WobblyMesh::updateOrigin(const QSizeF &size)
+{
+    const float xLength = size.width() / (Width - 1);
+    const float yLength = size.height() / (Height - 1);
+    for (int row = 0; row < Height; ++row) {
+        for (int column = 0; column < Width; ++column) {
+            const int i = row * Width + column;
+            m_origin.x[i] = column == Width - 1 ? size.width() : column * xLength;
+            m_origin.y[i] = row == Height - 1 ? size.height() : row * yLength;
+        }
+    }
+}
+
+void WobblyMesh::smooth(Values &values)
+{
+    // The sum over the 3x3 neighbourhood of every point is computed separably
+    Values rows;
+    for (int row = 0; row < Height; ++row) {
+        for (int column = 0; column < Width; ++column) {
+            const int i = row * Width + column;
+            const float left = column > 0 ? values[i - 1] : 0.0f;
+            const float right = column < Width - 1 ? values[i + 1] : 0.0f;
+            rows[i] = left + values[i] + right;
+        }
+    }
+    for (int i = 0; i < Count; ++i) {
+        const float above = i >= Width ? rows[i - Width] : 0.0f;
+        const float below = i < Count - Width ? rows[i + Width] : 0.0f;
+        const float ring = above + rows[i] + below - values[i];
+        values[i] = 0.5f * values[i] + ring * s_ringWeights[i];
+    }
+}
+
+WobblyMesh::Energy WobblyMesh::step(const QRectF &geometry, float time, const Parameters &parameters, Qt::Edges wobblyEdges)
+{
+    moveAnchor(geometry.topLeft());
+    updateOrigin(geometry.size());
+
+    const float xLength = geometry.width() / (Width - 1);
+    const float yLength = geometry.height() / (Height - 1);
+
+    // Every spring pulls or pushes both of its ends towards its rest length
+    Field force = {};
+    for (int row = 0; row < Height; ++row) {
+        for (int column = 0; column < Width - 1; ++column) {
+            const int i = row * Width + column;
+            const float dx = m_position.x[i + 1] - m_position.x[i] - xLength;
+            const float dy = m_position.y[i + 1] - m_position.y[i];
+            force.x[i] += dx;
+            force.y[i] += dy;
+            force.x[i + 1] -= dx;
+            force.y[i + 1] -= dy;
+        }
+    }
+    for (int i = 0; i < Count - Width; ++i) {
+        const float dx = m_position.x[i + Width] - m_position.x[i];
+        const float dy = m_position.y[i + Width] - m_position.y[i] - yLength;
+        force.x[i] += dx;
+        force.y[i] += dy;
+        force.x[i + Width] -= dx;
+        force.y[i + Width] -= dy;
+    }
+
+    for (int i = 0; i < Count; ++i) {
+        const float ax = force.x[i] * s_springWeights[i];
+        const float ay = force.y[i] * s_springWeights[i];
+        const float cx = m_origin.x[i] - m_position.x[i];
+        const float cy = m_origin.y[i] - m_position.y[i];
+        m_acceleration.x[i] = (m_constraint[i] ? cx : ax) * parameters.stiffness;
+        m_acceleration.y[i] = (m_constraint[i] ? cy : ay) * parameters.stiffness;
+    }
+
+    smooth(m_acceleration.x);
+    smooth(m_acceleration.y);
+
+    float accelerationSum = 0.0f;
+    for (int i = 0; i < Count; ++i) {
+        const float ax = clampMagnitude(m_acceleration.x[i], parameters.minAcceleration, parameters.maxAcceleration);
+        const float ay = clampMagnitude(m_acceleration.y[i], parameters.minAcceleration, parameters.maxAcceleration);
+        m_velocity.x[i] = ax * time + m_velocity.x[i] * parameters.drag;
+        m_velocity.y[i] = ay * time + m_velocity.y[i] * parameters.drag;
+        accelerationSum += std::abs(ax) + std::abs(ay);
+    }
+
+    smooth(m_velocity.x);
+    smooth(m_velocity.y);
+
+    float velocitySum = 0.0f;
+    const float move = time * parameters.moveFactor;
+    for (int i = 0; i < Count; ++i) {
+        const float vx = clampMagnitude(m_velocity.x[i], parameters.minVelocity, parameters.maxVelocity);
+        const float vy = clampMagnitude(m_velocity.y[i], parameters.minVelocity, parameters.maxVelocity);
+        m_velocity.x[i] = vx;
+        m_velocity.y[i] = vy;
+        m_position.x[i] += vx * move;
+        m_position.y[i] += vy * move;
+        velocitySum += std::abs(vx) + std::abs(vy);
+    }
+
+    // A side that cannot wobble pins all rows or columns but the opposite one
+    if (!(wobblyEdges & Qt::TopEdge)) {
+        for (int i = 0; i < Count - Width; ++i) {
+            m_position.y[i] = m_origin.y[i];
+        }
+    }
+    if (!(wobblyEdges & Qt::BottomEdge)) {
+        for (int i = Width; i < Count; ++i) {
+            m_position.y[i] = m_origin.y[i];
+        }
+    }
+    if (!(wobblyEdges & Qt::LeftEdge)) {
+        for (int i = 0; i < Count; ++i) {
+            if (i % Width != Width - 1) {
+                m_position.x[i] = m_origin.x[i];
+            }
+        }
+    }
+    if (!(wobblyEdges & Qt::RightEdge)) {
+        for (int i = 0; i < Count; ++i) {
+            if (i % Width != 0) {
+                m_position.x[i] = m_origin.x[i];
+            }
+        }
+    }
+
+    return Energy{
+        .acceleration = accelerationSum,
+        .velocity = velocitySum,
+    };
+}
+
+WobblyMesh::Curve WobblyMesh::curve(float v) const
+{
+    // Collapse the surface along v into a cubic curve, it's shared by the vertices in a row
+    const std::array<float, 4> weights = bernstein(v);
+    Curve curve;
+    curve.v = v;
+    for (int column = 0; column < Width; ++column) {
+        curve.x[column] = weights[0] * m_position.x[column] + weights[1] * m_position.x[Width + column]
+            + weights[2] * m_position.x[2 * Width + column] + weights[3] * m_position.x[3 * Width + column];
+        curve.y[column] = weights[0] * m_position.y[column] + weights[1] * m_position.y[Width + column]
+            + weights[2] * m_position.y[2 * Width + column] + weights[3] * m_position.y[3 * Width + column];
+    }
+    return curve;
+}
+
+QPointF WobblyMesh::map(qreal u, qreal v) const
+{
+    const Curve c = curve(v);
+    const std::array<float, 4> weights = bernstein(u);
+    const float x = weights[0] * c.x[0] + weights[1] * c.x[1] + weights[2] * c.x[2] + weights[3] * c.x[3];
+    const float y = weights[0] * c.y[0] + weights[1] * c.y[1] + weights[2] * c.y[2] + weights[3] * c.y[3];
+    return m_anchor + QPointF(x, y);
+}
+
+void WobblyMesh::deform(WindowQuadList &quads, const QSizeF &size, const QPointF &origin) const
+{
+    const float tx = m_anchor.x() - origin.x();
+    const float ty = m_anchor.y() - origin.y();
+    const float width = size.width();
+    const float height = size.height();
+
+    // The quads of a regular grid share the rows of vertices with their neighbours
+    std::array<Curve, 2> curves;
+    curves[0].v = curves[1].v = std::numeric_limits<float>::quiet_NaN();
+    int nextCurve = 0;
+
+    for (WindowQuad &quad : quads) {
+        for (int j = 0; j < 4; ++j) {
+            WindowVertex &vertex = quad[j];
+            const float u = vertex.x() / width;
+            const float v = vertex.y() / height;
+
+            const Curve *c;
+            if (curves[0].v == v) {
+                c = &curves[0];
+            } else if (curves[1].v == v) {
+                c = &curves[1];
+            } else {
+                curves[nextCurve] = curve(v);
+                c = &curves[nextCurve];
+                nextCurve ^= 1;
+            }
+
+            const std::array<float, 4> weights = bernstein(u);
+            const float x = weights[0] * c->x[0] + weights[1] * c->x[1] + weights[2] * c->x[2] + weights[3] * c->x[3];
+            const float y = weights[0] * c->y[0] + weights[1] * c->y[1] + weights[2] * c->y[2] + weights[3] * c->y[3];
+            vertex.move(x + tx, y + ty);
+        }
+    }
+}
+
+} // namespace KWin
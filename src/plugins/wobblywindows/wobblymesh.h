@@ -0,0 +1,119 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QPointF>
+#include <QRectF>
+
+#include <array>
+
+namespace KWin
+{
+
+class WindowQuadList;
+
+/**
+ * The WobblyMesh class simulates the grid of springs that makes windows wobble, and maps
+ * points of the window onto the bicubic Bezier surface spanned by the grid.
+ *
+ * The grid is stored as a structure of arrays of floats, one array per coordinate, so every
+ * pass over the grid is a plain loop over contiguous memory that the compiler can turn into
+ * SIMD code. The coordinates are relative to the top-left corner of the window, floats are
+ * not precise enough for sub-pixel movements far away from the origin of the screen.
+ */
+class WobblyMesh
+{
+public:
+    static constexpr int Width = 4;
+    static constexpr int Height = 4;
+    static constexpr int Count = Width * Height;
+
+    struct Parameters
+    {
+        float stiffness;
+        float drag;
+        float moveFactor;
+        float minVelocity;
+        float maxVelocity;
+        float minAcceleration;
+        float maxAcceleration;
+    };
+
+    /**
+     * The sums of the absolute acceleration and velocity components after a step, the
+     * mesh is at rest when both are small.
+     */
+    struct Energy
+    {
+        qreal acceleration;
+        qreal velocity;
+    };
+
+    /**
+     * Puts every point at its rest position in a window with the given @a geometry, and
+     * clears the velocities and the constraints.
+     */
+    void reset(const QRectF &geometry);
+
+    /**
+     * Advances the simulation by @a time milliseconds for a window with the given
+     * @a geometry. The sides not in @a wobblyEdges stay at their rest position.
+     */
+    Energy step(const QRectF &geometry, float time, const Parameters &parameters, Qt::Edges wobblyEdges);
+
+    /**
+     * A constrained point is only pulled towards its rest position, its neighbours are
+     * ignored.
+     */
+    void setConstrained(int index, bool constrained);
+    void setVelocity(int index, const QPointF &velocity);
+
+    /**
+     * Returns the point of the surface at the normalized coordinates @a u and @a v.
+     */
+    QPointF map(qreal u, qreal v) const;
+
+    /**
+     * Moves the vertices of the @a quads, which are in the coordinate space of a window of
+     * the given @a size, onto the surface. The new positions are relative to @a origin.
+     */
+    void deform(WindowQuadList &quads, const QSizeF &size, const QPointF &origin) const;
+
+private:
+    using Values = std::array<float, Count>;
+
+    struct Field
+    {
+        alignas(16) Values x;
+        alignas(16) Values y;
+    };
+
+    struct Curve
+    {
+        float v;
+        std::array<float, Width> x;
+        std::array<float, Width> y;
+    };
+
+    void moveAnchor(const QPointF &anchor);
+    void updateOrigin(const QSizeF &size);
+    Curve curve(float v) const;
+
+    static void smooth(Values &values);
+
+    QPointF m_anchor;
+    Field m_origin = {};
+    Field m_position = {};
+    Field m_velocity = {};
+    Field m_acceleration = {};
+    std::array<bool, Count> m_constraint = {};
+};
+
+} // namespace KWin
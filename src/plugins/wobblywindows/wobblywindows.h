@@ -12,6 +12,8 @@
 // Include with base class for effects.
 #include "effect/offscreeneffect.h"
 
+#include "wobblymesh.h"
+
 namespace KWin
 {
 
@@ -60,12 +62,6 @@ public:
     void setVelocityThreshold(qreal velocityThreshold);
     void setMoveFactor(qreal factor);
 
-    struct Pair
-    {
-        qreal x;
-        qreal y;
-    };
-
     enum WindowStatus {
         Free,
         Moving,
@@ -105,24 +101,7 @@ private:
 
     struct WindowWobblyInfos
     {
-        QList<Pair> origin;
-        QList<Pair> position;
-        QList<Pair> velocity;
-        QList<Pair> acceleration;
-        QList<Pair> buffer;
-
-        // if true, the physics system moves this point based only on it "normal" destination
-        // given by the window position, ignoring neighbour points.
-        QList<bool> constraint;
-
-        unsigned int width;
-        unsigned int height;
-        unsigned int count;
-
-        QList<Pair> bezierSurface;
-        unsigned int bezierWidth;
-        unsigned int bezierHeight;
-        unsigned int bezierCount;
+        WobblyMesh mesh;
 
         WindowStatus status;
 
@@ -159,10 +138,6 @@ private:
 
     void initWobblyInfo(WindowWobblyInfos &wwi, QRectF geometry) const;
 
-    WobblyWindowsEffect::Pair computeBezierPoint(const WindowWobblyInfos &wwi, Pair point) const;
-
-    static void heightRingLinearMean(QList<Pair> &data, WindowWobblyInfos &wwi);
-
     void setParameterSet(const ParameterSet &pset);
 };
 
@@ -5,7 +5,9 @@
 */
 
 #include "scene/item.h"
+#include "core/pixelgrid.h"
 #include "core/renderlayer.h"
+#include "effect/globals.h"
 #include "scene/scene.h"
 #include "utils/common.h"
 
@@ -124,6 +126,7 @@ void Item::setPosition(const QPointF &point)
     if (m_position != point) {
         scheduleRepaint(boundingRect());
         m_position = point;
+        m_deviceTransform.reset();
         if (m_parentItem) {
             m_parentItem->updateBoundingRect();
         }
@@ -204,7 +207,27 @@ QMatrix4x4 Item::transform() const
 
 void Item::setTransform(const QMatrix4x4 &transform)
 {
-    m_transform = transform;
+    if (m_transform != transform) {
+        m_transform = transform;
+        m_deviceTransform.reset();
+    }
+}
+
+QMatrix4x4 Item::deviceTransform(qreal scale) const
+{
+    if (!m_deviceTransform.has_value() || m_deviceTransform->scale != scale) {
+        const auto logicalPosition = QVector2D(m_position.x(), m_position.y());
+
+        QMatrix4x4 matrix;
+        matrix.translate(roundVector(logicalPosition * scale).toVector3D());
+        matrix *= m_transform;
+
+        m_deviceTransform = DeviceTransform{
+            .scale = scale,
+            .matrix = matrix,
+        };
+    }
+    return m_deviceTransform->matrix;
 }
 
 QRegion Item::mapToGlobal(const QRegion &region) const
@@ -350,6 +373,7 @@ WindowQuadList Item::buildQuads() const
 void Item::discardQuads()
 {
     m_quads.reset();
+    m_deviceGeometry.reset();
 }
 
 WindowQuadList Item::quads() const
@@ -360,6 +384,42 @@ WindowQuadList Item::quads() const
     return m_quads.value();
 }
 
+void Item::updateDeviceGeometry(qreal scale) const
+{
+    if (m_deviceGeometry.has_value() && m_deviceGeometry->scale == scale) {
+        return;
+    }
+
+    const WindowQuadList quads = this->quads();
+
+    RenderGeometry geometry;
+    geometry.reserve(quads.count() * 6);
+
+    QRectF bounds;
+    for (const WindowQuad &quad : quads) {
+        geometry.appendWindowQuad(quad, scale);
+        bounds |= snapToPixelGridF(scaledRect(quad.bounds(), scale));
+    }
+
+    m_deviceGeometry = DeviceGeometry{
+        .scale = scale,
+        .geometry = geometry,
+        .bounds = bounds,
+    };
+}
+
+RenderGeometry Item::deviceGeometry(qreal scale) const
+{
+    updateDeviceGeometry(scale);
+    return m_deviceGeometry->geometry;
+}
+
+QRectF Item::deviceBounds(qreal scale) const
+{
+    updateDeviceGeometry(scale);
+    return m_deviceGeometry->bounds;
+}
+
 QRegion Item::repaints(SceneDelegate *delegate) const
 {
     return m_repaints.value(delegate);
@@ -110,6 +110,22 @@ public:
     void resetRepaints(SceneDelegate *delegate);
 
     WindowQuadList quads() const;
+    /**
+     * Returns the quads of the item converted to device coordinates with the given @a scale.
+     *
+     * The geometry is retained between frames and rebuilt only after the quads have been
+     * discarded or the scale has changed.
+     */
+    RenderGeometry deviceGeometry(qreal scale) const;
+    /**
+     * Returns the rectangle that encloses deviceGeometry(), snapped to the pixel grid.
+     */
+    QRectF deviceBounds(qreal scale) const;
+    /**
+     * Returns the transform that maps the item's device coordinates to its parent's device
+     * coordinates, i.e. the item's position followed by transform().
+     */
+    QMatrix4x4 deviceTransform(qreal scale) const;
     virtual void preprocess();
     const ColorDescription &colorDescription() const;
 
@@ -142,6 +158,7 @@ private:
     void scheduleRepaintInternal(const QRegion &region);
     void scheduleRepaintInternal(SceneDelegate *delegate, const QRegion &region);
     void markSortedChildItemsDirty();
+    void updateDeviceGeometry(qreal scale) const;
 
     bool computeEffectiveVisibility() const;
     void updateEffectiveVisibility();
@@ -160,6 +177,21 @@ private:
     bool m_effectiveVisible = true;
     QMap<SceneDelegate *, QRegion> m_repaints;
     mutable std::optional<WindowQuadList> m_quads;
+
+    struct DeviceGeometry
+    {
+        qreal scale;
+        RenderGeometry geometry;
+        QRectF bounds;
+    };
+    mutable std::optional<DeviceGeometry> m_deviceGeometry;
+
+    struct DeviceTransform
+    {
+        qreal scale;
+        QMatrix4x4 matrix;
+    };
+    mutable std::optional<DeviceTransform> m_deviceTransform;
     mutable std::optional<QList<Item *>> m_sortedChildItems;
     ColorDescription m_colorDescription = ColorDescription::sRGB;
 };
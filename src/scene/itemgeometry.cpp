@@ -6,10 +6,13 @@
 */
 
 #include "scene/itemgeometry.h"
+#include "core/pixelgrid.h"
 #include "effect/globals.h"
 
 #include <QMatrix4x4>
 
+#include <algorithm>
+
 namespace KWin
 {
 
@@ -298,4 +301,106 @@ void RenderGeometry::postProcessTextureCoordinates(const QMatrix4x4 &textureMatr
     }
 }
 
+DeviceClipRegion::DeviceClipRegion(const QRegion &region, qreal deviceScale)
+{
+    m_rects.reserve(region.rectCount());
+
+    // QRegion stores its rects in y-x sorted bands, which is preserved when snapping to the
+    // pixel grid because all rects in a band share the same top and bottom edges. Bands are
+    // split the same way as in the region, with scales below 1, neighbour bands can snap to
+    // the same edges but their rects together are not sorted by x.
+    QRect previousRect;
+    bool newBand = true;
+    for (const QRect &rect : region) {
+        if (rect.top() != previousRect.top() || rect.bottom() != previousRect.bottom()) {
+            newBand = true;
+        }
+        previousRect = rect;
+
+        const QRectF deviceRect = snapToPixelGridF(scaledRect(rect, deviceScale));
+        if (deviceRect.isEmpty()) {
+            continue;
+        }
+
+        if (newBand) {
+            newBand = false;
+            m_bands.append(Band{
+                .top = deviceRect.top(),
+                .bottom = deviceRect.bottom(),
+                .first = m_rects.size(),
+                .last = m_rects.size(),
+            });
+        }
+
+        m_rects.append(deviceRect);
+        m_bands.last().last = m_rects.size();
+    }
+}
+
+bool DeviceClipRegion::isEmpty() const
+{
+    return m_rects.isEmpty();
+}
+
+template<typename Visitor>
+void DeviceClipRegion::forEachCandidate(const QRectF &rect, Visitor visitor) const
+{
+    // The candidate rects are looked up with some slack to account for rounding errors when the
+    // rect is translated, the visitor is expected to perform the exact intersection test.
+    static const qreal slack = 1.0;
+    const qreal left = rect.left() - slack;
+    const qreal top = rect.top() - slack;
+    const qreal right = rect.right() + slack;
+    const qreal bottom = rect.bottom() + slack;
+
+    auto band = std::partition_point(m_bands.cbegin(), m_bands.cend(), [top](const Band &band) {
+        return band.bottom <= top;
+    });
+    for (; band != m_bands.cend() && band->top < bottom; ++band) {
+        const auto bandBegin = m_rects.cbegin() + band->first;
+        const auto bandEnd = m_rects.cbegin() + band->last;
+
+        auto candidate = std::partition_point(bandBegin, bandEnd, [left](const QRectF &rect) {
+            return rect.right() <= left;
+        });
+        for (; candidate != bandEnd && candidate->left() < right; ++candidate) {
+            if (!visitor(*candidate)) {
+                return;
+            }
+        }
+    }
+}
+
+bool DeviceClipRegion::contains(const QRectF &rect, const QPointF &translation) const
+{
+    bool contained = false;
+    forEachCandidate(rect.translated(translation), [&](const QRectF &clipRect) {
+        contained = clipRect.translated(-translation).contains(rect);
+        return !contained;
+    });
+    return contained;
+}
+
+void DeviceClipRegion::clip(const WindowQuadList &quads, const QPointF &translation, qreal deviceScale, RenderGeometry &geometry) const
+{
+    for (const WindowQuad &quad : quads) {
+        // Scale to device coordinates, rounding as needed.
+        const QRectF deviceBounds = snapToPixelGridF(scaledRect(quad.bounds(), deviceScale));
+
+        forEachCandidate(deviceBounds.translated(translation), [&](const QRectF &clipRect) {
+            const QRectF intersected = clipRect.translated(-translation).intersected(deviceBounds);
+            if (intersected.isValid()) {
+                if (deviceBounds == intersected) {
+                    // case 1: completely contains, include and do not check other rects
+                    geometry.appendWindowQuad(quad, deviceScale);
+                    return false;
+                }
+                // case 2: intersection
+                geometry.appendSubQuad(quad, intersected, deviceScale);
+            }
+            return true;
+        });
+    }
+}
+
 } // namespace KWin
@@ -201,6 +201,59 @@ private:
     VertexSnappingMode m_vertexSnappingMode = VertexSnappingMode::Round;
 };
 
+/**
+ * A helper class for clipping window quads against a region in device coordinates.
+ *
+ * The rects of the region are converted to device coordinates once and grouped in horizontal
+ * bands sorted from top to bottom, with the rects in every band sorted from left to right. This
+ * way, clipping a quad only needs to look at the rects that overlap it rather than at every rect
+ * in the region.
+ */
+class KWIN_EXPORT DeviceClipRegion
+{
+public:
+    DeviceClipRegion() = default;
+    /**
+     * Constructs a clip region from the given @a region in logical coordinates.
+     *
+     * @param region The region in logical coordinates.
+     * @param deviceScale The scaling factor to use to go from logical to device coordinates.
+     */
+    DeviceClipRegion(const QRegion &region, qreal deviceScale);
+
+    bool isEmpty() const;
+
+    /**
+     * Returns @c true if a single rect of the region contains the given @a rect. The rect is
+     * expected to be in device coordinates and relative to @a translation.
+     */
+    bool contains(const QRectF &rect, const QPointF &translation) const;
+    /**
+     * Clip the given @a quads against the region and append the result to @a geometry.
+     *
+     * @param quads The quads to clip, in logical coordinates.
+     * @param translation The position of the quads' origin in device coordinates.
+     * @param deviceScale The scaling factor to use to go from logical to device coordinates.
+     * @param geometry The geometry that clipped quads are appended to.
+     */
+    void clip(const WindowQuadList &quads, const QPointF &translation, qreal deviceScale, RenderGeometry &geometry) const;
+
+private:
+    struct Band
+    {
+        qreal top;
+        qreal bottom;
+        qsizetype first;
+        qsizetype last;
+    };
+
+    template<typename Visitor>
+    void forEachCandidate(const QRectF &rect, Visitor visitor) const;
+
+    QList<QRectF> m_rects;
+    QList<Band> m_bands;
+};
+
 inline WindowVertex::WindowVertex()
     : px(0)
     , py(0)
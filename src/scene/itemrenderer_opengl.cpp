@@ -98,39 +98,31 @@ static OpenGLSurfaceContents bindSurfaceTexture(SurfaceItem *surfaceItem)
 
 static RenderGeometry clipQuads(const Item *item, const ItemRendererOpenGL::RenderContext *context)
 {
-    const WindowQuadList quads = item->quads();
+    const qreal scale = context->renderTargetScale;
+    if (context->clip == infiniteRegion() || context->hardwareClipping) {
+        return item->deviceGeometry(scale);
+    }
 
     // Item to world translation.
     const QPointF worldTranslation = context->transformStack.top().map(QPointF(0., 0.));
-    const qreal scale = context->renderTargetScale;
+    const QRectF itemDeviceBounds = item->deviceBounds(scale);
+    if (itemDeviceBounds.isEmpty()) {
+        return RenderGeometry();
+    }
+
+    // If a single clip rect contains the whole item, every quad is going to be included as is,
+    // so the retained geometry can be reused without clipping individual quads.
+    if (context->deviceClip.contains(itemDeviceBounds, worldTranslation)) {
+        return item->deviceGeometry(scale);
+    }
+
+    const WindowQuadList quads = item->quads();
 
     RenderGeometry geometry;
     geometry.reserve(quads.count() * 6);
 
     // split all quads in bounding rect with the actual rects in the region
-    for (const WindowQuad &quad : std::as_const(quads)) {
-        if (context->clip != infiniteRegion() && !context->hardwareClipping) {
-            // Scale to device coordinates, rounding as needed.
-            QRectF deviceBounds = snapToPixelGridF(scaledRect(quad.bounds(), scale));
-
-            for (const QRect &clipRect : std::as_const(context->clip)) {
-                QRectF deviceClipRect = snapToPixelGridF(scaledRect(clipRect, scale)).translated(-worldTranslation);
-
-                const QRectF &intersected = deviceClipRect.intersected(deviceBounds);
-                if (intersected.isValid()) {
-                    if (deviceBounds == intersected) {
-                        // case 1: completely contains, include and do not check other rects
-                        geometry.appendWindowQuad(quad, scale);
-                        break;
-                    }
-                    // case 2: intersection
-                    geometry.appendSubQuad(quad, intersected, scale);
-                }
-            }
-        } else {
-            geometry.appendWindowQuad(quad, scale);
-        }
-    }
+    context->deviceClip.clip(quads, worldTranslation, scale, geometry);
 
     return geometry;
 }
@@ -139,12 +131,8 @@ void ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context)
 {
     const QList<Item *> sortedChildItems = item->sortedChildItems();
 
-    QMatrix4x4 matrix;
-    const auto logicalPosition = QVector2D(item->position().x(), item->position().y());
     const auto scale = context->renderTargetScale;
-    matrix.translate(roundVector(logicalPosition * scale).toVector3D());
-    matrix *= item->transform();
-    context->transformStack.push(context->transformStack.top() * matrix);
+    context->transformStack.push(context->transformStack.top() * item->deviceTransform(scale));
 
     context->opacityStack.push(context->opacityStack.top() * item->opacity());
 
@@ -259,11 +247,15 @@ void ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
         return;
     }
 
+    const bool hardwareClipping = region != infiniteRegion() && ((mask & Scene::PAINT_WINDOW_TRANSFORMED) || (mask & Scene::PAINT_SCREEN_TRANSFORMED));
+    const bool softwareClipping = region != infiniteRegion() && !hardwareClipping;
+
     RenderContext renderContext{
         .projectionMatrix = data.projectionMatrix(),
         .clip = region,
-        .hardwareClipping = region != infiniteRegion() && ((mask & Scene::PAINT_WINDOW_TRANSFORMED) || (mask & Scene::PAINT_SCREEN_TRANSFORMED)),
+        .hardwareClipping = hardwareClipping,
         .renderTargetScale = viewport.scale(),
+        .deviceClip = softwareClipping ? DeviceClipRegion(region, viewport.scale()) : DeviceClipRegion(),
     };
 
     renderContext.transformStack.push(QMatrix4x4());
@@ -39,6 +39,7 @@ public:
         const QRegion clip;
         const bool hardwareClipping;
         const qreal renderTargetScale;
+        const DeviceClipRegion deviceClip;
     };
 
     ItemRendererOpenGL();
@@ -0,0 +1,169 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/occlusionmap.h"
+
+#include <cmath>
+
+namespace KWin
+{
+
+// Rects that span more tiles than this are not bucketed
+static constexpr qint64 s_maxTilesPerRect = 64;
+
+OcclusionMap::OcclusionMap(int tileSize)
+    : m_tileSize(tileSize)
+{
+}
+
+void OcclusionMap::clear()
+{
+    m_rects.clear();
+    m_largeRects.clear();
+    m_occupiedTiles = 0;
+    // Keep the buckets around, the same tiles are likely to be used in the next frame. Drop the
+    // ones that weren't used in the last frame though, e.g. after a window has been moved away.
+    std::erase_if(m_tiles, [](const auto &entry) {
+        return entry.second.empty();
+    });
+    for (auto &[key, tile] : m_tiles) {
+        tile.clear();
+    }
+}
+
+bool OcclusionMap::isEmpty() const
+{
+    return m_rects.empty();
+}
+
+quint64 OcclusionMap::tileKey(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+void OcclusionMap::add(const QRegion &region)
+{
+    for (const QRect &rect : region) {
+        if (rect.isEmpty()) {
+            continue;
+        }
+
+        const uint32_t index = m_rects.size();
+        m_rects.push_back(rect);
+
+        const int x0 = std::floor(rect.left() / double(m_tileSize));
+        const int y0 = std::floor(rect.top() / double(m_tileSize));
+        const int x1 = std::floor(rect.right() / double(m_tileSize));
+        const int y1 = std::floor(rect.bottom() / double(m_tileSize));
+        if (qint64(x1 - x0 + 1) * (y1 - y0 + 1) > s_maxTilesPerRect) {
+            m_largeRects.push_back(index);
+            continue;
+        }
+
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                std::vector<uint32_t> &tile = m_tiles[tileKey(x, y)];
+                if (tile.empty()) {
+                    ++m_occupiedTiles;
+                }
+                tile.push_back(index);
+            }
+        }
+    }
+}
+
+template<typename Func>
+void OcclusionMap::forEachCandidate(const QRect &rect, Func func) const
+{
+    const int x0 = std::floor(rect.left() / double(m_tileSize));
+    const int y0 = std::floor(rect.top() / double(m_tileSize));
+    const int x1 = std::floor(rect.right() / double(m_tileSize));
+    const int y1 = std::floor(rect.bottom() / double(m_tileSize));
+
+    // If the queried rect spans more tiles than there are occupied ones, it's cheaper to look at every rect
+    if (qint64(x1 - x0 + 1) * (y1 - y0 + 1) > m_occupiedTiles) {
+        for (const QRect &candidate : m_rects) {
+            if (candidate.intersects(rect)) {
+                if (!func(candidate)) {
+                    return;
+                }
+            }
+        }
+        return;
+    }
+
+    for (uint32_t index : m_largeRects) {
+        if (m_rects[index].intersects(rect)) {
+            if (!func(m_rects[index])) {
+                return;
+            }
+        }
+    }
+
+    if (m_visited.size() < m_rects.size()) {
+        m_visited.resize(m_rects.size(), m_stamp);
+    }
+    if (++m_stamp == 0) {
+        // the stamp has wrapped around, make sure that no rect is considered as visited
+        std::fill(m_visited.begin(), m_visited.end(), 0);
+        m_stamp = 1;
+    }
+
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const auto tile = m_tiles.find(tileKey(x, y));
+            if (tile == m_tiles.end()) {
+                continue;
+            }
+            for (uint32_t index : tile->second) {
+                if (m_visited[index] == m_stamp) {
+                    continue;
+                }
+                m_visited[index] = m_stamp;
+                if (m_rects[index].intersects(rect)) {
+                    if (!func(m_rects[index])) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool OcclusionMap::contains(const QRect &rect) const
+{
+    if (rect.isEmpty()) {
+        return true;
+    }
+    if (m_rects.empty()) {
+        return false;
+    }
+
+    QRegion remaining = rect;
+    forEachCandidate(rect, [&remaining](const QRect &candidate) {
+        remaining -= candidate;
+        return !remaining.isEmpty();
+    });
+    return remaining.isEmpty();
+}
+
+QRegion OcclusionMap::subtracted(const QRegion &region) const
+{
+    if (region.isEmpty() || m_rects.empty()) {
+        return region;
+    }
+
+    QRegion remaining = region;
+    forEachCandidate(region.boundingRect(), [&remaining](const QRect &candidate) {
+        if (remaining.intersects(candidate)) {
+            remaining -= candidate;
+        }
+        return !remaining.isEmpty();
+    });
+    return remaining;
+}
+
+} // namespace KWin
@@ -0,0 +1,67 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QRegion>
+
+#include <unordered_map>
+#include <vector>
+
+namespace KWin
+{
+
+/**
+ * The OcclusionMap class accumulates the opaque areas of windows while the scene is walked
+ * from top to bottom, and answers which parts of a region are still visible.
+ *
+ * Unlike a QRegion, the opaque rects are never merged. They are bucketed in a grid of tiles so
+ * a query only looks at the rects near the queried area, which keeps occlusion culling linear
+ * even if the opaque regions are very fragmented, e.g. due to rounded corners.
+ */
+class KWIN_EXPORT OcclusionMap
+{
+public:
+    explicit OcclusionMap(int tileSize = 256);
+
+    void clear();
+    bool isEmpty() const;
+
+    /**
+     * Marks the given @a region as opaque.
+     */
+    void add(const QRegion &region);
+
+    /**
+     * Returns @c true if the given @a rect is completely covered by opaque areas.
+     */
+    bool contains(const QRect &rect) const;
+
+    /**
+     * Returns the part of the given @a region that is not covered by opaque areas.
+     */
+    QRegion subtracted(const QRegion &region) const;
+
+private:
+    template<typename Func>
+    void forEachCandidate(const QRect &rect, Func func) const;
+    static quint64 tileKey(int x, int y);
+
+    const int m_tileSize;
+    std::vector<QRect> m_rects;
+    // Rects that span too many tiles are kept aside and tested against every query
+    std::vector<uint32_t> m_largeRects;
+    std::unordered_map<quint64, std::vector<uint32_t>> m_tiles;
+    // The number of tiles that contain at least one rect, empty buckets may be kept for reuse
+    qint64 m_occupiedTiles = 0;
+    // Used to visit every rect only once per query, even if it's in several tiles
+    mutable std::vector<uint32_t> m_visited;
+    mutable uint32_t m_stamp = 0;
+};
+
+} // namespace KWin
@@ -87,6 +87,8 @@ void SurfaceItem::addDamage(const QRegion &region)
     const qreal xScale = sourceBox.width() / size().width();
     const qreal yScale = sourceBox.height() / size().height();
     const QRegion logicalDamage = mapFromBuffer(region);
+    // The area that is actually repainted, including the padding for fractional scales
+    QRegion paddedDamage = logicalDamage;
 
     const auto delegates = scene()->delegates();
     for (SceneDelegate *delegate : delegates) {
@@ -97,11 +99,12 @@ void SurfaceItem::addDamage(const QRegion &region)
             const int xPadding = std::ceil(0.5 / xScale);
             const int yPadding = std::ceil(0.5 / yScale);
             delegateDamage = expandRegion(delegateDamage, QMargins(xPadding, yPadding, xPadding, yPadding));
+            paddedDamage += delegateDamage;
         }
         scheduleRepaint(delegate, delegateDamage);
     }
 
-    Q_EMIT damaged();
+    Q_EMIT damaged(paddedDamage);
 }
 
 void SurfaceItem::resetDamage()
@@ -57,7 +57,16 @@ public:
     virtual void freeze();
 
 Q_SIGNALS:
-    void damaged();
+    /**
+     * This signal is emitted when the given @a region of the item, in the item's local logical
+     * coordinates, has been damaged.
+     */
+    void damaged(const QRegion &region);
+    /**
+     * This signal is emitted when the item or one of its children has been shown, hidden,
+     * restacked or removed. Such changes don't damage the surface itself.
+     */
+    void layoutChanged();
 
 protected:
     explicit SurfaceItem(Scene *scene, Item *parent = nullptr);
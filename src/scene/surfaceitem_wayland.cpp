@@ -130,6 +130,7 @@ SurfaceItemWayland *SurfaceItemWayland::getOrCreateSubSurfaceItem(SubSurfaceInte
 void SurfaceItemWayland::handleChildSubSurfaceRemoved(SubSurfaceInterface *child)
 {
     m_subsurfaces.erase(child);
+    Q_EMIT layoutChanged();
 }
 
 void SurfaceItemWayland::handleChildSubSurfacesChanged()
@@ -146,6 +147,8 @@ void SurfaceItemWayland::handleChildSubSurfacesChanged()
         SurfaceItemWayland *subsurfaceItem = getOrCreateSubSurfaceItem(above[i]);
         subsurfaceItem->setZ(i);
     }
+
+    Q_EMIT layoutChanged();
 }
 
 void SurfaceItemWayland::handleSubSurfacePositionChanged()
@@ -156,6 +159,7 @@ void SurfaceItemWayland::handleSubSurfacePositionChanged()
 void SurfaceItemWayland::handleSubSurfaceMappedChanged()
 {
     setVisible(m_surface->isMapped());
+    Q_EMIT layoutChanged();
 }
 
 std::unique_ptr<SurfacePixmap> SurfaceItemWayland::createPixmap()
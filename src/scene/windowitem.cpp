@@ -194,7 +194,18 @@ void WindowItem::updatePosition()
 void WindowItem::addSurfaceItemDamageConnects(Item *item)
 {
     auto surfaceItem = static_cast<SurfaceItem *>(item);
-    connect(surfaceItem, &SurfaceItem::damaged, this, &WindowItem::markDamaged);
+    connect(surfaceItem, &SurfaceItem::damaged, this, [this, surfaceItem](const QRegion &region) {
+        markDamaged(surfaceItem->mapToGlobal(region));
+    });
+    // Surfaces that move, resize or are restacked change the window without damaging any
+    // buffer, the damage can't be narrowed down to what actually changed
+    const auto markFullyDamaged = [this]() {
+        markDamaged(infiniteRegion());
+    };
+    connect(surfaceItem, &SurfaceItem::positionChanged, this, markFullyDamaged);
+    connect(surfaceItem, &SurfaceItem::sizeChanged, this, markFullyDamaged);
+    connect(surfaceItem, &SurfaceItem::layoutChanged, this, markFullyDamaged);
+    connect(surfaceItem, &SurfaceItem::childAdded, this, markFullyDamaged);
     connect(surfaceItem, &SurfaceItem::childAdded, this, &WindowItem::addSurfaceItemDamageConnects);
     const auto childItems = item->childItems();
     for (const auto &child : childItems) {
@@ -246,7 +257,7 @@ void WindowItem::updateShadowItem()
         } else if (m_surfaceItem) {
             m_shadowItem->stackBefore(m_surfaceItem.get());
         }
-        markDamaged();
+        markDamaged(infiniteRegion());
     } else {
         m_shadowItem.reset();
     }
@@ -264,8 +275,11 @@ void WindowItem::updateDecorationItem()
         } else if (m_surfaceItem) {
             m_decorationItem->stackBefore(m_surfaceItem.get());
         }
-        connect(m_window->decoration(), &KDecoration2::Decoration::damaged, this, &WindowItem::markDamaged);
-        markDamaged();
+        connect(m_window->decoration(), &KDecoration2::Decoration::damaged, this, [this](const QRegion &region) {
+            // The decoration is in the frame coordinates, same as the window item
+            markDamaged(mapToGlobal(region));
+        });
+        markDamaged(infiniteRegion());
     } else {
         m_decorationItem.reset();
     }
@@ -285,9 +299,9 @@ void WindowItem::updateStackingOrder()
     }
 }
 
-void WindowItem::markDamaged()
+void WindowItem::markDamaged(const QRegion &region)
 {
-    Q_EMIT m_window->damaged(m_window);
+    Q_EMIT m_window->damaged(m_window, region);
 }
 
 void WindowItem::freeze()
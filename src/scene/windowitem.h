@@ -73,7 +73,7 @@ private Q_SLOTS:
 private:
     bool computeVisibility() const;
     void updateVisibility();
-    void markDamaged();
+    void markDamaged(const QRegion &region);
     void freeze();
 
     Window *m_window;
@@ -54,6 +54,7 @@
 
 #include "scene/workspacescene.h"
 #include "compositor.h"
+#include "core/frametelemetry.h"
 #include "core/output.h"
 #include "core/renderbackend.h"
 #include "core/renderlayer.h"
@@ -225,6 +226,8 @@ void WorkspaceScene::frame(SceneDelegate *delegate, OutputFrame *frame)
 
 QRegion WorkspaceScene::prePaint(SceneDelegate *delegate)
 {
+    const auto prePaintStart = std::chrono::steady_clock::now();
+
     createStackingOrder();
 
     painted_delegate = delegate;
@@ -234,7 +237,7 @@ QRegion WorkspaceScene::prePaint(SceneDelegate *delegate)
         painted_screen = painted_delegate->output();
     }
 
-    const RenderLoop *renderLoop = painted_screen->renderLoop();
+    RenderLoop *renderLoop = painted_screen->renderLoop();
     const std::chrono::milliseconds presentTime =
         std::chrono::duration_cast<std::chrono::milliseconds>(renderLoop->nextPresentationTimestamp());
 
@@ -263,11 +266,15 @@ QRegion WorkspaceScene::prePaint(SceneDelegate *delegate)
     m_paintContext.phase2Data.clear();
 
     if (m_paintContext.mask & (PAINT_SCREEN_TRANSFORMED | PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS)) {
+        renderLoop->setFrameClass(RenderLoop::FrameClass::Generic);
         preparePaintGenericScreen();
     } else {
+        renderLoop->setFrameClass(RenderLoop::FrameClass::Simple);
         preparePaintSimpleScreen();
     }
 
+    renderLoop->telemetry()->addStageTime(FrameTelemetry::Stage::PrePaint, std::chrono::steady_clock::now() - prePaintStart);
+
     return m_paintContext.damage.translated(-delegate->viewport().topLeft());
 }
 
@@ -344,12 +351,12 @@ void WorkspaceScene::preparePaintSimpleScreen()
     }
 
     // Perform an occlusion cull pass, remove surface damage occluded by opaque windows.
-    QRegion opaque;
+    m_occlusionMap.clear();
     for (int i = m_paintContext.phase2Data.size() - 1; i >= 0; --i) {
         const auto &paintData = m_paintContext.phase2Data.at(i);
-        m_paintContext.damage += paintData.region - opaque;
+        m_paintContext.damage += m_occlusionMap.subtracted(paintData.region);
         if (!(paintData.mask & (PAINT_WINDOW_TRANSLUCENT | PAINT_WINDOW_TRANSFORMED))) {
-            opaque += paintData.opaque;
+            m_occlusionMap.add(paintData.opaque);
         }
     }
 
@@ -360,6 +367,8 @@ void WorkspaceScene::preparePaintSimpleScreen()
 
 void WorkspaceScene::postPaint()
 {
+    const auto postPaintStart = std::chrono::steady_clock::now();
+
     for (WindowItem *w : std::as_const(stacking_order)) {
         effects->postPaintWindow(w->effectWindow());
     }
@@ -367,12 +376,15 @@ void WorkspaceScene::postPaint()
     effects->postPaintScreen();
 
     clearStackingOrder();
+
+    painted_screen->renderLoop()->telemetry()->addStageTime(FrameTelemetry::Stage::PostPaint, std::chrono::steady_clock::now() - postPaintStart);
 }
 
 void WorkspaceScene::paint(const RenderTarget &renderTarget, const QRegion &region)
 {
     Output *output = kwinApp()->operationMode() == Application::OperationMode::OperationModeX11 ? nullptr : painted_screen;
     RenderViewport viewport(output ? output->fractionalGeometry() : workspace()->geometry(), output ? output->scale() : 1, renderTarget);
+    const auto paintStart = std::chrono::steady_clock::now();
 
     m_renderer->beginFrame(renderTarget, viewport);
 
@@ -381,6 +393,8 @@ void WorkspaceScene::paint(const RenderTarget &renderTarget, const QRegion &regi
     Q_EMIT frameRendered();
 
     m_renderer->endFrame();
+
+    painted_screen->renderLoop()->telemetry()->addStageTime(FrameTelemetry::Stage::Paint, std::chrono::steady_clock::now() - paintStart);
 }
 
 // the function that'll be eventually called by paintScreen() above
@@ -416,22 +430,29 @@ void WorkspaceScene::paintGenericScreen(const RenderTarget &renderTarget, const
 // to reduce painting and improve performance.
 void WorkspaceScene::paintSimpleScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int, const QRegion &region)
 {
-    // This is the occlusion culling pass
-    QRegion visible = region;
+    // This is the occlusion culling pass, windows that are completely covered by opaque
+    // windows above them get an empty region and are not rendered at all.
+    m_occlusionMap.clear();
     for (int i = m_paintContext.phase2Data.size() - 1; i >= 0; --i) {
         Phase2Data *data = &m_paintContext.phase2Data[i];
-        data->region = visible;
 
         if (!(data->mask & PAINT_WINDOW_TRANSFORMED)) {
-            data->region &= data->item->mapToGlobal(data->item->boundingRect()).toAlignedRect();
+            const QRect bounds = data->item->mapToGlobal(data->item->boundingRect()).toAlignedRect();
+            if (m_occlusionMap.contains(bounds)) {
+                data->region = QRegion();
+            } else {
+                data->region = m_occlusionMap.subtracted(region & bounds);
+            }
 
             if (!(data->mask & PAINT_WINDOW_TRANSLUCENT)) {
-                visible -= data->opaque;
+                m_occlusionMap.add(data->opaque);
             }
+        } else {
+            data->region = m_occlusionMap.subtracted(region);
         }
     }
 
-    m_renderer->renderBackground(renderTarget, viewport, visible);
+    m_renderer->renderBackground(renderTarget, viewport, m_occlusionMap.subtracted(region));
 
     for (const Phase2Data &paintData : std::as_const(m_paintContext.phase2Data)) {
         paintWindow(renderTarget, viewport, paintData.item, paintData.mask, paintData.region);
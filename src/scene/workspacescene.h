@@ -10,6 +10,7 @@
 #pragma once
 
 #include "core/colorspace.h"
+#include "scene/occlusionmap.h"
 #include "scene/scene.h"
 
 namespace KWin
@@ -128,6 +129,7 @@ private:
     // how many times finalPaintScreen() has been called
     int m_paintScreenCount = 0;
     PaintContext m_paintContext;
+    OcclusionMap m_occlusionMap;
     std::unique_ptr<Item> m_containerItem;
     std::unique_ptr<DragAndDropIconItem> m_dndIcon;
 };
@@ -22,6 +22,7 @@
 #include "shadow.h"
 #include "window.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 
@@ -93,69 +94,79 @@ std::pair<std::shared_ptr<GLTexture>, ColorDescription> WorkspaceSceneOpenGL::te
 //****************************************
 // SceneOpenGL::Shadow
 //****************************************
-class DecorationShadowTextureCache
+using ShadowTiles = std::array<QImage, Shadow::ShadowElementsCount>;
+
+/**
+ * The ShadowTextureCache class shares shadow textures between windows. Decoration shadows
+ * are identified by the decoration shadow object, other shadows by the contents of their tiles.
+ */
+class ShadowTextureCache
 {
 public:
-    ~DecorationShadowTextureCache();
-    DecorationShadowTextureCache(const DecorationShadowTextureCache &) = delete;
-    static DecorationShadowTextureCache &instance();
+    ~ShadowTextureCache();
+    ShadowTextureCache(const ShadowTextureCache &) = delete;
+    static ShadowTextureCache &instance();
 
     void unregister(ShadowTextureProvider *provider);
+    std::shared_ptr<GLTexture> getDecorationTexture(ShadowTextureProvider *provider);
     std::shared_ptr<GLTexture> getTexture(ShadowTextureProvider *provider);
 
 private:
-    DecorationShadowTextureCache() = default;
+    ShadowTextureCache() = default;
     struct Data
     {
         std::shared_ptr<GLTexture> texture;
         QList<ShadowTextureProvider *> providers;
     };
-    QHash<KDecoration2::DecorationShadow *, Data> m_cache;
+    struct TileData : Data
+    {
+        ShadowTiles tiles;
+    };
+    QHash<KDecoration2::DecorationShadow *, Data> m_decorationShadows;
+    QMultiHash<size_t, TileData> m_tileShadows;
 };
 
-DecorationShadowTextureCache &DecorationShadowTextureCache::instance()
+ShadowTextureCache &ShadowTextureCache::instance()
 {
-    static DecorationShadowTextureCache s_instance;
+    static ShadowTextureCache s_instance;
     return s_instance;
 }
 
-DecorationShadowTextureCache::~DecorationShadowTextureCache()
+ShadowTextureCache::~ShadowTextureCache()
 {
-    Q_ASSERT(m_cache.isEmpty());
+    Q_ASSERT(m_decorationShadows.isEmpty());
+    Q_ASSERT(m_tileShadows.isEmpty());
 }
 
-void DecorationShadowTextureCache::unregister(ShadowTextureProvider *provider)
+template<typename Cache>
+static void unregisterProvider(Cache &cache, ShadowTextureProvider *provider)
 {
-    auto it = m_cache.begin();
-    while (it != m_cache.end()) {
-        auto &d = it.value();
-        // check whether the Vector of Shadows contains our shadow and remove all of them
-        auto glIt = d.providers.begin();
-        while (glIt != d.providers.end()) {
-            if (*glIt == provider) {
-                glIt = d.providers.erase(glIt);
-            } else {
-                glIt++;
-            }
-        }
+    auto it = cache.begin();
+    while (it != cache.end()) {
         // if there are no shadows any more we can erase the cache entry
-        if (d.providers.isEmpty()) {
-            it = m_cache.erase(it);
+        if (it->providers.removeAll(provider) && it->providers.isEmpty()) {
+            it = cache.erase(it);
         } else {
             it++;
         }
     }
 }
 
-std::shared_ptr<GLTexture> DecorationShadowTextureCache::getTexture(ShadowTextureProvider *provider)
+void ShadowTextureCache::unregister(ShadowTextureProvider *provider)
+{
+    unregisterProvider(m_decorationShadows, provider);
+    unregisterProvider(m_tileShadows, provider);
+}
+
+std::shared_ptr<GLTexture> ShadowTextureCache::getDecorationTexture(ShadowTextureProvider *provider)
 {
     Shadow *shadow = provider->shadow();
     Q_ASSERT(shadow->hasDecorationShadow());
     unregister(provider);
     const auto decoShadow = shadow->decorationShadow().lock();
     Q_ASSERT(decoShadow);
-    auto it = m_cache.find(decoShadow.get());
-    if (it != m_cache.end()) {
+    auto it = m_decorationShadows.find(decoShadow.get());
+    if (it != m_decorationShadows.end()) {
         Q_ASSERT(!it.value().providers.contains(provider));
         it.value().providers << provider;
         return it.value().texture;
@@ -168,104 +179,145 @@ std::shared_ptr<GLTexture> DecorationShadowTextureCache::getTexture(ShadowTextur
     }
     d.texture->setFilter(GL_LINEAR);
     d.texture->setWrapMode(GL_CLAMP_TO_EDGE);
-    m_cache.insert(decoShadow.get(), d);
+    m_decorationShadows.insert(decoShadow.get(), d);
     return d.texture;
 }
 
-OpenGLShadowTextureProvider::OpenGLShadowTextureProvider(Shadow *shadow)
-    : ShadowTextureProvider(shadow)
+static bool isAlphaOnly(const QImage &image)
 {
-}
-
-OpenGLShadowTextureProvider::~OpenGLShadowTextureProvider()
-{
-    if (m_texture) {
-        Compositor::self()->scene()->makeOpenGLContextCurrent();
-        DecorationShadowTextureCache::instance().unregister(this);
-        m_texture.reset();
+    if (image.isNull()) {
+        return true;
     }
+    Q_ASSERT(image.format() == QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < image.height(); ++y) {
+        const uint32_t *const src = reinterpret_cast<const uint32_t *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            if (src[x] & 0x00ffffff) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
-void OpenGLShadowTextureProvider::update()
+/**
+ * Uploads the shadow tiles directly to their places in a new texture.
+ */
+static std::unique_ptr<GLTexture> createShadowTexture(const ShadowTiles &tiles)
 {
-    if (m_shadow->hasDecorationShadow()) {
-        // simplifies a lot by going directly to
-        m_texture = DecorationShadowTextureCache::instance().getTexture(this);
-        return;
-    }
-
-    const QSize top(m_shadow->shadowElement(Shadow::ShadowElementTop).size());
-    const QSize topRight(m_shadow->shadowElement(Shadow::ShadowElementTopRight).size());
-    const QSize right(m_shadow->shadowElement(Shadow::ShadowElementRight).size());
-    const QSize bottom(m_shadow->shadowElement(Shadow::ShadowElementBottom).size());
-    const QSize bottomLeft(m_shadow->shadowElement(Shadow::ShadowElementBottomLeft).size());
-    const QSize left(m_shadow->shadowElement(Shadow::ShadowElementLeft).size());
-    const QSize topLeft(m_shadow->shadowElement(Shadow::ShadowElementTopLeft).size());
-    const QSize bottomRight(m_shadow->shadowElement(Shadow::ShadowElementBottomRight).size());
+    const QSize top(tiles[Shadow::ShadowElementTop].size());
+    const QSize topRight(tiles[Shadow::ShadowElementTopRight].size());
+    const QSize right(tiles[Shadow::ShadowElementRight].size());
+    const QSize bottom(tiles[Shadow::ShadowElementBottom].size());
+    const QSize bottomLeft(tiles[Shadow::ShadowElementBottomLeft].size());
+    const QSize left(tiles[Shadow::ShadowElementLeft].size());
+    const QSize topLeft(tiles[Shadow::ShadowElementTopLeft].size());
+    const QSize bottomRight(tiles[Shadow::ShadowElementBottomRight].size());
 
     const int width = std::max({topLeft.width(), left.width(), bottomLeft.width()}) + std::max(top.width(), bottom.width()) + std::max({topRight.width(), right.width(), bottomRight.width()});
     const int height = std::max({topLeft.height(), top.height(), topRight.height()}) + std::max(left.height(), right.height()) + std::max({bottomLeft.height(), bottom.height(), bottomRight.height()});
 
     if (width == 0 || height == 0) {
-        return;
+        return nullptr;
     }
 
-    QImage image(width, height, QImage::Format_ARGB32);
-    image.fill(Qt::transparent);
+    // Check if the tiles are alpha-only in practice, and if so use an 8-bpp format
+    bool alphaOnly = false;
+    if (!GLPlatform::instance()->isGLES() && GLTexture::supportsSwizzle() && GLTexture::supportsFormatRG()) {
+        alphaOnly = std::all_of(tiles.begin(), tiles.end(), isAlphaOnly);
+    }
+
+    std::unique_ptr<GLTexture> texture = GLTexture::allocate(alphaOnly ? GL_R8 : GL_RGBA8, QSize(width, height));
+    if (!texture) {
+        return nullptr;
+    }
+    texture->setContentTransform(TextureTransform::MirrorY);
+    texture->setFilter(GL_LINEAR);
+    texture->setWrapMode(GL_CLAMP_TO_EDGE);
+    texture->clear();
 
     const int innerRectTop = std::max({topLeft.height(), top.height(), topRight.height()});
     const int innerRectLeft = std::max({topLeft.width(), left.width(), bottomLeft.width()});
 
-    QPainter p;
-    p.begin(&image);
+    const auto place = [&](Shadow::ShadowElements element, const QPoint &position) {
+        const QImage &tile = tiles[element];
+        if (!tile.isNull()) {
+            texture->update(alphaOnly ? tile.convertToFormat(QImage::Format_Alpha8) : tile, position);
+        }
+    };
 
-    p.drawImage(QRectF(0, 0, topLeft.width(), topLeft.height()), m_shadow->shadowElement(Shadow::ShadowElementTopLeft));
-    p.drawImage(QRectF(innerRectLeft, 0, top.width(), top.height()), m_shadow->shadowElement(Shadow::ShadowElementTop));
-    p.drawImage(QRectF(width - topRight.width(), 0, topRight.width(), topRight.height()), m_shadow->shadowElement(Shadow::ShadowElementTopRight));
+    place(Shadow::ShadowElementTopLeft, QPoint(0, 0));
+    place(Shadow::ShadowElementTop, QPoint(innerRectLeft, 0));
+    place(Shadow::ShadowElementTopRight, QPoint(width - topRight.width(), 0));
 
-    p.drawImage(QRectF(0, innerRectTop, left.width(), left.height()), m_shadow->shadowElement(Shadow::ShadowElementLeft));
-    p.drawImage(QRectF(width - right.width(), innerRectTop, right.width(), right.height()), m_shadow->shadowElement(Shadow::ShadowElementRight));
+    place(Shadow::ShadowElementLeft, QPoint(0, innerRectTop));
+    place(Shadow::ShadowElementRight, QPoint(width - right.width(), innerRectTop));
 
-    p.drawImage(QRectF(0, height - bottomLeft.height(), bottomLeft.width(), bottomLeft.height()), m_shadow->shadowElement(Shadow::ShadowElementBottomLeft));
-    p.drawImage(QRectF(innerRectLeft, height - bottom.height(), bottom.width(), bottom.height()), m_shadow->shadowElement(Shadow::ShadowElementBottom));
-    p.drawImage(QRectF(width - bottomRight.width(), height - bottomRight.height(), bottomRight.width(), bottomRight.height()), m_shadow->shadowElement(Shadow::ShadowElementBottomRight));
+    place(Shadow::ShadowElementBottomLeft, QPoint(0, height - bottomLeft.height()));
+    place(Shadow::ShadowElementBottom, QPoint(innerRectLeft, height - bottom.height()));
+    place(Shadow::ShadowElementBottomRight, QPoint(width - bottomRight.width(), height - bottomRight.height()));
 
-    p.end();
+    if (alphaOnly) {
+        // Swizzle red to alpha and all other channels to zero
+        texture->bind();
+        texture->setSwizzle(GL_ZERO, GL_ZERO, GL_ZERO, GL_RED);
+    }
 
-    // Check if the image is alpha-only in practice, and if so convert it to an 8-bpp format
-    if (!GLPlatform::instance()->isGLES() && GLTexture::supportsSwizzle() && GLTexture::supportsFormatRG()) {
-        QImage alphaImage(image.size(), QImage::Format_Alpha8);
-        bool alphaOnly = true;
+    return texture;
+}
 
-        for (ptrdiff_t y = 0; alphaOnly && y < image.height(); y++) {
-            const uint32_t *const src = reinterpret_cast<const uint32_t *>(image.scanLine(y));
-            uint8_t *const dst = reinterpret_cast<uint8_t *>(alphaImage.scanLine(y));
+std::shared_ptr<GLTexture> ShadowTextureCache::getTexture(ShadowTextureProvider *provider)
+{
+    Shadow *shadow = provider->shadow();
+    unregister(provider);
 
-            for (ptrdiff_t x = 0; x < image.width(); x++) {
-                if (src[x] & 0x00ffffff) {
-                    alphaOnly = false;
-                }
+    ShadowTiles tiles;
+    size_t hash = 0;
+    for (int i = 0; i < Shadow::ShadowElementsCount; ++i) {
+        tiles[i] = shadow->shadowElement(Shadow::ShadowElements(i)).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        hash = qHashMulti(hash, tiles[i].width(), tiles[i].height(), qHashBits(tiles[i].constBits(), tiles[i].sizeInBytes()));
+    }
 
-                dst[x] = qAlpha(src[x]);
-            }
+    // Many windows use identical shadows, the hash only narrows down the candidates
+    for (auto it = m_tileShadows.find(hash); it != m_tileShadows.end() && it.key() == hash; ++it) {
+        if (it->tiles == tiles) {
+            it->providers << provider;
+            return it->texture;
         }
+    }
 
-        if (alphaOnly) {
-            image = alphaImage;
-        }
+    TileData d;
+    d.texture = createShadowTexture(tiles);
+    if (!d.texture) {
+        return nullptr;
     }
+    d.providers << provider;
+    d.tiles = std::move(tiles);
+    m_tileShadows.insert(hash, d);
+    return d.texture;
+}
 
-    m_texture = GLTexture::upload(image);
-    if (!m_texture) {
-        return;
+OpenGLShadowTextureProvider::OpenGLShadowTextureProvider(Shadow *shadow)
+    : ShadowTextureProvider(shadow)
+{
+}
+
+OpenGLShadowTextureProvider::~OpenGLShadowTextureProvider()
+{
+    if (m_texture) {
+        Compositor::self()->scene()->makeOpenGLContextCurrent();
+        ShadowTextureCache::instance().unregister(this);
+        m_texture.reset();
     }
-    m_texture->setFilter(GL_LINEAR);
-    m_texture->setWrapMode(GL_CLAMP_TO_EDGE);
+}
 
-    if (m_texture->internalFormat() == GL_R8) {
-        // Swizzle red to alpha and all other channels to zero
-        m_texture->bind();
-        m_texture->setSwizzle(GL_ZERO, GL_ZERO, GL_ZERO, GL_RED);
+void OpenGLShadowTextureProvider::update()
+{
+    if (m_shadow->hasDecorationShadow()) {
+        // simplifies a lot by going directly to
+        m_texture = ShadowTextureCache::instance().getDecorationTexture(this);
+    } else {
+        m_texture = ShadowTextureCache::instance().getTexture(this);
     }
 }
 
@@ -359,13 +411,31 @@ void SceneOpenGLDecorationRenderer::render(const QRegion &region)
 
     const QRect dirtyRect = region.boundingRect();
 
-    renderPart(top.toRect().intersected(dirtyRect), top.toRect(), topPosition, devicePixelRatio);
-    renderPart(bottom.toRect().intersected(dirtyRect), bottom.toRect(), bottomPosition, devicePixelRatio);
-    renderPart(left.toRect().intersected(dirtyRect), left.toRect(), leftPosition, devicePixelRatio, true);
-    renderPart(right.toRect().intersected(dirtyRect), right.toRect(), rightPosition, devicePixelRatio, true);
+    renderPart(DecorationPart::Top, top.toRect().intersected(dirtyRect), top.toRect(), topPosition, devicePixelRatio);
+    renderPart(DecorationPart::Bottom, bottom.toRect().intersected(dirtyRect), bottom.toRect(), bottomPosition, devicePixelRatio);
+    renderPart(DecorationPart::Left, left.toRect().intersected(dirtyRect), left.toRect(), leftPosition, devicePixelRatio, true);
+    renderPart(DecorationPart::Right, right.toRect().intersected(dirtyRect), right.toRect(), rightPosition, devicePixelRatio, true);
+}
+
+// Only updates up to this size are compared against the previous upload of the same part
+static constexpr size_t s_maxComparedPixels = 16 * 1024;
+
+/**
+ * Returns an image of the given @a size that paints into memory shared by all decoration
+ * renderers. Decorations are repainted often, allocating a new image every time is wasteful.
+ * The returned image is only valid until the next call.
+ */
+static QImage scratchImage(const QSize &size)
+{
+    static std::vector<uint32_t> pixels;
+    const size_t pixelCount = size_t(size.width()) * size.height();
+    if (pixels.size() < pixelCount) {
+        pixels.resize(pixelCount);
+    }
+    return QImage(reinterpret_cast<uchar *>(pixels.data()), size.width(), size.height(), size.width() * sizeof(uint32_t), QImage::Format_ARGB32_Premultiplied);
 }
 
-void SceneOpenGLDecorationRenderer::renderPart(const QRect &rect, const QRect &partRect,
+void SceneOpenGLDecorationRenderer::renderPart(DecorationPart part, const QRect &rect, const QRect &partRect,
                                                const QPoint &textureOffset,
                                                qreal devicePixelRatio, bool rotated)
 {
@@ -387,7 +457,7 @@ void SceneOpenGLDecorationRenderer::renderPart(const QRect &rect, const QRect &p
     QSize paddedImageSize = imageSize;
     paddedImageSize.rheight() += verticalPadding;
     paddedImageSize.rwidth() += horizontalPadding;
-    QImage image(paddedImageSize, QImage::Format_ARGB32_Premultiplied);
+    QImage image = scratchImage(paddedImageSize);
     image.setDevicePixelRatio(devicePixelRatio);
     image.fill(Qt::transparent);
 
@@ -417,7 +487,25 @@ void SceneOpenGLDecorationRenderer::renderPart(const QRect &rect, const QRect &p
     if (padding.left() == 0) {
         dirtyOffset.rx() += TexturePad;
     }
-    m_texture->update(image, textureOffset + dirtyOffset);
+
+    // Decorations often repaint small areas without changing anything, e.g. a button when a
+    // property it doesn't display changes, skip the upload if the texture already contains the
+    // same pixels. Large updates are uploaded right away, keeping a copy of them isn't worth it
+    const QRect uploadRect(textureOffset + dirtyOffset, image.size());
+    const uint32_t *pixels = reinterpret_cast<const uint32_t *>(image.constBits());
+    const size_t pixelCount = size_t(image.width()) * image.height();
+    UploadedPart &uploaded = m_uploadedParts[int(part)];
+    if (pixelCount > s_maxComparedPixels) {
+        uploaded = UploadedPart{};
+    } else {
+        if (uploaded.rect == uploadRect && std::equal(pixels, pixels + pixelCount, uploaded.pixels.cbegin(), uploaded.pixels.cend())) {
+            return;
+        }
+        uploaded.rect = uploadRect;
+        uploaded.pixels.assign(pixels, pixels + pixelCount);
+    }
+
+    m_texture->update(image, uploadRect.topLeft());
 }
 
 const QMargins SceneOpenGLDecorationRenderer::texturePadForPart(
@@ -458,6 +546,9 @@ void SceneOpenGLDecorationRenderer::resizeTexture()
     size.rwidth() += 2 * TexturePad;
     size.rwidth() = align(size.width(), 128);
 
+    // The layout of the parts in the texture may change even if its size doesn't
+    m_uploadedParts = {};
+
     if (m_texture && m_texture->size() == size) {
         return;
     }
@@ -18,6 +18,9 @@
 
 #include "opengl/glutils.h"
 
+#include <array>
+#include <vector>
+
 namespace KWin
 {
 class OpenGLBackend;
@@ -98,11 +101,19 @@ public:
     }
 
 private:
-    void renderPart(const QRect &rect, const QRect &partRect, const QPoint &textureOffset, qreal devicePixelRatio, bool rotated = false);
+    void renderPart(DecorationPart part, const QRect &rect, const QRect &partRect, const QPoint &textureOffset, qreal devicePixelRatio, bool rotated = false);
     static const QMargins texturePadForPart(const QRect &rect, const QRect &partRect);
     void resizeTexture();
     int toNativeSize(int size) const;
     std::unique_ptr<GLTexture> m_texture;
+
+    // The last small image uploaded for every part, so repaints that don't change anything can skip the upload
+    struct UploadedPart
+    {
+        QRect rect;
+        std::vector<uint32_t> pixels;
+    };
+    std::array<UploadedPart, int(DecorationPart::Count)> m_uploadedParts;
 };
 
 } // namespace
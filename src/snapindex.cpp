@@ -0,0 +1,108 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "snapindex.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+
+// The snapping code works with truncated coordinates, so look a bit further than asked
+static constexpr qreal s_slack = 2.0;
+
+void SnapIndex::insert(Window *window, const QRectF &geometry)
+{
+    auto it = m_entries.find(window);
+    if (it != m_entries.end()) {
+        if (it->geometry == geometry) {
+            return;
+        }
+        removeEdge(m_verticalEdges, it->geometry.left(), window);
+        removeEdge(m_verticalEdges, it->geometry.right(), window);
+        removeEdge(m_horizontalEdges, it->geometry.top(), window);
+        removeEdge(m_horizontalEdges, it->geometry.bottom(), window);
+        it->geometry = geometry;
+    } else {
+        m_entries.insert(window, Entry{
+                                     .geometry = geometry,
+                                     .serial = m_serial++,
+                                 });
+    }
+
+    insertEdge(m_verticalEdges, geometry.left(), window);
+    insertEdge(m_verticalEdges, geometry.right(), window);
+    insertEdge(m_horizontalEdges, geometry.top(), window);
+    insertEdge(m_horizontalEdges, geometry.bottom(), window);
+}
+
+void SnapIndex::remove(Window *window)
+{
+    const auto it = m_entries.constFind(window);
+    if (it == m_entries.constEnd()) {
+        return;
+    }
+
+    removeEdge(m_verticalEdges, it->geometry.left(), window);
+    removeEdge(m_verticalEdges, it->geometry.right(), window);
+    removeEdge(m_horizontalEdges, it->geometry.top(), window);
+    removeEdge(m_horizontalEdges, it->geometry.bottom(), window);
+    m_entries.erase(it);
+}
+
+bool SnapIndex::contains(Window *window) const
+{
+    return m_entries.contains(window);
+}
+
+QList<Window *> SnapIndex::candidates(const QList<qreal> &xPositions, const QList<qreal> &yPositions, qreal snapZone, Reach reach) const
+{
+    QList<Window *> windows;
+    collect(m_verticalEdges, xPositions, snapZone, reach, windows);
+    collect(m_horizontalEdges, yPositions, snapZone, reach, windows);
+
+    std::sort(windows.begin(), windows.end(), [this](Window *a, Window *b) {
+        return m_entries.value(a).serial < m_entries.value(b).serial;
+    });
+    windows.erase(std::unique(windows.begin(), windows.end()), windows.end());
+    return windows;
+}
+
+void SnapIndex::insertEdge(Edges &edges, qreal position, Window *window)
+{
+    edges.emplace(position, window);
+}
+
+void SnapIndex::removeEdge(Edges &edges, qreal position, Window *window)
+{
+    auto [it, end] = edges.equal_range(position);
+    for (; it != end; ++it) {
+        if (it->second == window) {
+            edges.erase(it);
+            return;
+        }
+    }
+}
+
+void SnapIndex::collect(const Edges &edges, QList<qreal> positions, qreal snapZone, Reach reach, QList<Window *> &windows)
+{
+    const qreal range = snapZone + s_slack;
+
+    // New positions may be appended while the list is walked if the reach is transitive
+    for (qsizetype i = 0; i < positions.size(); ++i) {
+        const qreal position = positions[i];
+        auto it = edges.lower_bound(position - range);
+        const auto end = edges.upper_bound(position + range);
+        for (; it != end; ++it) {
+            windows.append(it->second);
+            if (reach == Reach::Transitive && !positions.contains(it->first)) {
+                positions.append(it->first);
+            }
+        }
+    }
+}
+
+} // namespace KWin
@@ -0,0 +1,78 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+
+#include <map>
+
+namespace KWin
+{
+
+class Window;
+
+/**
+ * The SnapIndex class keeps the edges of windows sorted by their coordinates so the
+ * windows that a window can snap to can be found without looking at every window.
+ *
+ * The index doesn't know anything about the snapping rules, it only narrows down the
+ * candidates. The windows are never dereferenced.
+ */
+class KWIN_EXPORT SnapIndex
+{
+public:
+    /**
+     * Adds the @a window with the given frame @a geometry to the index, or updates its
+     * geometry if it's in the index already.
+     */
+    void insert(Window *window, const QRectF &geometry);
+    void remove(Window *window);
+    bool contains(Window *window) const;
+
+    enum class Reach {
+        /**
+         * Only the edges within the snap zone of the given positions are considered.
+         */
+        Direct,
+        /**
+         * The edges within the snap zone of other found edges are considered too. This is
+         * needed if the snapped window edge may move to a found edge while snapping.
+         */
+        Transitive,
+    };
+
+    /**
+     * Returns the windows that have a vertical edge within @a snapZone of any of the
+     * @a xPositions or a horizontal edge within @a snapZone of any of the @a yPositions.
+     * The windows are returned in the same order as they were inserted.
+     */
+    QList<Window *> candidates(const QList<qreal> &xPositions, const QList<qreal> &yPositions, qreal snapZone, Reach reach = Reach::Direct) const;
+
+private:
+    using Edges = std::multimap<qreal, Window *>;
+
+    struct Entry
+    {
+        QRectF geometry;
+        quint64 serial;
+    };
+
+    static void insertEdge(Edges &edges, qreal position, Window *window);
+    static void removeEdge(Edges &edges, qreal position, Window *window);
+    static void collect(const Edges &edges, QList<qreal> positions, qreal snapZone, Reach reach, QList<Window *> &windows);
+
+    Edges m_verticalEdges;
+    Edges m_horizontalEdges;
+    QHash<Window *, Entry> m_entries;
+    quint64 m_serial = 0;
+};
+
+} // namespace KWin
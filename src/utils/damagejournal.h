@@ -11,11 +11,17 @@
 #include <QList>
 #include <QRegion>
 
+#include <algorithm>
+
 namespace KWin
 {
 
 /**
  * The DamageJournal class is a helper that tracks last N damage regions.
+ *
+ * The damage regions are stored in a ring buffer. The unions of the most recent damage
+ * regions are cached and extended as needed, so accumulating damage for a given buffer
+ * age only needs to compute unions that have not been computed since the last add().
  */
 class KWIN_EXPORT DamageJournal
 {
@@ -34,7 +40,21 @@ public:
      */
     void setCapacity(int capacity)
     {
+        if (m_capacity == capacity) {
+            return;
+        }
+
+        QList<QRegion> log;
+        log.reserve(capacity);
+        for (int i = 0; i < std::min(m_size, capacity); ++i) {
+            log.append(at(i));
+        }
+
+        m_log = log;
+        m_head = 0;
+        m_size = log.size();
         m_capacity = capacity;
+        m_unions.clear();
     }
 
     /**
@@ -42,10 +62,17 @@ public:
      */
     void add(const QRegion &region)
     {
-        while (m_log.size() >= m_capacity) {
-            m_log.takeLast();
+        if (m_capacity <= 0) {
+            return;
+        }
+        if (m_log.size() != m_capacity) {
+            m_log.resize(m_capacity);
         }
-        m_log.prepend(region);
+
+        m_head = (m_head + m_capacity - 1) % m_capacity;
+        m_log[m_head] = region;
+        m_size = std::min(m_size + 1, m_capacity);
+        m_unions.clear();
     }
 
     /**
@@ -55,6 +82,9 @@ public:
     void clear()
     {
         m_log.clear();
+        m_head = 0;
+        m_size = 0;
+        m_unions.clear();
     }
 
     /**
@@ -65,24 +95,43 @@ public:
      */
     QRegion accumulate(int bufferAge, const QRegion &fallback = QRegion()) const
     {
-        QRegion region;
-        if (bufferAge > 0 && bufferAge <= m_log.size()) {
-            for (int i = 0; i < bufferAge - 1; ++i) {
-                region |= m_log[i];
+        if (bufferAge <= 0 || bufferAge > m_size) {
+            return fallback;
+        }
+        if (bufferAge == 1) {
+            return QRegion();
+        }
+
+        // m_unions[i] holds the union of the i + 1 most recent damage regions.
+        const int count = bufferAge - 1;
+        if (m_unions.size() < count) {
+            m_unions.reserve(m_size);
+            if (m_unions.isEmpty()) {
+                m_unions.append(at(0));
+            }
+            for (int i = m_unions.size(); i < count; ++i) {
+                m_unions.append(m_unions.constLast() | at(i));
             }
-        } else {
-            region = fallback;
         }
-        return region;
+        return m_unions[count - 1];
     }
 
     QRegion lastDamage() const
     {
-        return m_log.first();
+        Q_ASSERT(m_size > 0);
+        return at(0);
     }
 
 private:
+    const QRegion &at(int index) const
+    {
+        return m_log[(m_head + index) % m_capacity];
+    }
+
     QList<QRegion> m_log;
+    mutable QList<QRegion> m_unions;
+    int m_head = 0;
+    int m_size = 0;
     int m_capacity = 10;
 };
 
@@ -0,0 +1,45 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/debugstatistics.h"
+
+namespace KWin
+{
+
+DebugStatistics *DebugStatistics::self()
+{
+    static DebugStatistics instance;
+    return &instance;
+}
+
+void DebugStatistics::add(QObject *source)
+{
+    if (m_sources.contains(source)) {
+        return;
+    }
+    m_sources.append(source);
+    connect(source, &QObject::destroyed, this, [this, source]() {
+        remove(source);
+    });
+    Q_EMIT sourceAdded(source);
+}
+
+void DebugStatistics::remove(QObject *source)
+{
+    if (m_sources.removeOne(source)) {
+        disconnect(source, nullptr, this, nullptr);
+        Q_EMIT sourceRemoved(source);
+    }
+}
+
+QList<QObject *> DebugStatistics::sources() const
+{
+    return m_sources;
+}
+
+} // namespace KWin
+
+#include "moc_debugstatistics.cpp"
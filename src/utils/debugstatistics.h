@@ -0,0 +1,49 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QList>
+#include <QObject>
+
+namespace KWin
+{
+
+/**
+ * The DebugStatistics class keeps track of objects that expose runtime statistics, such as
+ * counters and latencies, as properties.
+ *
+ * The properties of every registered object are shown in the Statistics tab of the debug
+ * console. The properties are polled, so they don't need to have notify signals, but their
+ * getters must be cheap and safe to call from the main thread.
+ */
+class KWIN_EXPORT DebugStatistics : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DebugStatistics *self();
+
+    /**
+     * Registers the given @a source. The object's name is used as its title in the debug
+     * console. The source is unregistered automatically when it's destroyed.
+     */
+    void add(QObject *source);
+    void remove(QObject *source);
+
+    QList<QObject *> sources() const;
+
+Q_SIGNALS:
+    void sourceAdded(QObject *source);
+    void sourceRemoved(QObject *source);
+
+private:
+    QList<QObject *> m_sources;
+};
+
+} // namespace KWin
@@ -78,10 +78,13 @@ RamFile::RamFile(const char *name, const void *inData, int size, RamFile::Flags
     m_tmp->unmap(data);
 #endif
 
-    int seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+    int seals = F_SEAL_SHRINK | F_SEAL_GROW;
     if (flags.testFlag(RamFile::Flag::SealWrite)) {
         seals |= F_SEAL_WRITE;
     }
+    if (!flags.testFlag(RamFile::Flag::Sealable)) {
+        seals |= F_SEAL_SEAL;
+    }
     // This can fail for QTemporaryFile based on the underlying file system.
     if (fcntl(fd(), F_ADD_SEALS, seals) != 0) {
         qCDebug(KWIN_CORE).nospace() << name << ": Failed to seal RamFile: " << strerror(errno);
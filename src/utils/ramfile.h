@@ -54,6 +54,7 @@ public:
      */
     enum class Flag {
         SealWrite = 1 << 0, ///< Seal the file descriptor for writing.
+        Sealable = 1 << 1, ///< Don't seal the seals, so more can be added after the file was created.
     };
     Q_DECLARE_FLAGS(Flags, Flag)
 
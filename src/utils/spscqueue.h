@@ -0,0 +1,114 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <vector>
+
+namespace KWin
+{
+
+/**
+ * The SpscQueue class is a bounded lock-free queue with a single producer thread and a
+ * single consumer thread.
+ *
+ * All slots are allocated upfront, pushing and popping never allocates memory or takes
+ * a lock. push() may only be called by the producer thread; front() and pop() may only be
+ * called by the consumer thread.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    /**
+     * Creates a queue that can hold at least @a capacity elements.
+     */
+    explicit SpscQueue(size_t capacity)
+        : m_slots(std::bit_ceil(capacity))
+        , m_mask(m_slots.size() - 1)
+    {
+    }
+
+    size_t capacity() const
+    {
+        return m_slots.size();
+    }
+
+    /**
+     * Returns @c true if the queue is empty. The result is only a snapshot if it's called
+     * by the producer thread.
+     */
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns @c true if the queue is full. This may only be called by the producer thread.
+     * If the queue isn't full, the next push() is guaranteed to succeed.
+     */
+    bool isFull() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        return tail - m_head.load(std::memory_order_acquire) == m_slots.size();
+    }
+
+    /**
+     * Appends the given @a value to the queue. Returns @c false if the queue is full.
+     */
+    bool push(T &&value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == m_slots.size()) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_slots.size()) {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Returns the oldest element in the queue, or @c nullptr if the queue is empty.
+     */
+    T *front()
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return nullptr;
+            }
+        }
+        return &m_slots[head & m_mask];
+    }
+
+    /**
+     * Removes the oldest element from the queue. The queue must not be empty.
+     */
+    void pop()
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        m_slots[head & m_mask] = T();
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+private:
+    std::vector<T> m_slots;
+    const size_t m_mask;
+
+    // The producer and the consumer indices live on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<size_t> m_head = 0;
+    size_t m_cachedTail = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+    size_t m_cachedHead = 0;
+};
+
+} // namespace KWin
@@ -4,7 +4,9 @@
     SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
 */
 #include "clientconnection.h"
+#include "clientconnection_p.h"
 #include "display.h"
+#include "utils/debugstatistics.h"
 #include "utils/executable_path.h"
 // Qt
 #include <QFileInfo>
@@ -14,32 +16,36 @@
 
 namespace KWin
 {
-class ClientConnectionPrivate
-{
-public:
-    ClientConnectionPrivate(wl_client *c, Display *display, ClientConnection *q);
-    ~ClientConnectionPrivate();
-
-    wl_client *client;
-    Display *display;
-    pid_t pid = 0;
-    uid_t user = 0;
-    gid_t group = 0;
-    QString executablePath;
-    QString securityContextAppId;
-    qreal scaleOverride = 1.0;
-
-private:
-    static void destroyListenerCallback(wl_listener *listener, void *data);
-    static void destroyLateListenerCallback(wl_listener *listener, void *data);
-    ClientConnection *q;
-    wl_listener destroyListener;
-    wl_listener destroyLateListener;
-    static QList<ClientConnectionPrivate *> s_allClients;
-};
+void RateCounter::add(std::chrono::steady_clock::time_point timestamp)
+{
+    const auto elapsed = timestamp - m_windowStart;
+    if (elapsed >= std::chrono::seconds(1)) {
+        m_previous = elapsed < std::chrono::seconds(2) ? m_current : 0;
+        m_current = 0;
+        m_windowStart = timestamp;
+    }
+    m_current++;
+}
+
+uint RateCounter::rate(std::chrono::steady_clock::time_point timestamp) const
+{
+    const auto elapsed = timestamp - m_windowStart;
+    if (elapsed < std::chrono::seconds(1)) {
+        return m_previous;
+    } else if (elapsed < std::chrono::seconds(2)) {
+        return m_current;
+    } else {
+        return 0;
+    }
+}
 
 QList<ClientConnectionPrivate *> ClientConnectionPrivate::s_allClients;
 
+ClientConnectionPrivate *ClientConnectionPrivate::get(ClientConnection *connection)
+{
+    return connection->d.get();
+}
+
 ClientConnectionPrivate::ClientConnectionPrivate(wl_client *c, Display *display, ClientConnection *q)
     : client(c)
     , display(display)
@@ -62,6 +68,16 @@ ClientConnectionPrivate::~ClientConnectionPrivate()
     s_allClients.removeAt(s_allClients.indexOf(this));
 }
 
+void ClientConnectionPrivate::accountRequest(quint32 size, bool commit, std::chrono::steady_clock::time_point timestamp)
+{
+    requestCount++;
+    requestBytes += size;
+    requestRate.add(timestamp);
+    if (commit) {
+        commitRate.add(timestamp);
+    }
+}
+
 void ClientConnectionPrivate::destroyListenerCallback(wl_listener *listener, void *data)
 {
     wl_client *client = reinterpret_cast<wl_client *>(data);
@@ -95,6 +111,9 @@ ClientConnection::ClientConnection(wl_client *c, Display *parent)
     : QObject(parent)
     , d(new ClientConnectionPrivate(c, parent, this))
 {
+    const QString executable = d->executablePath.isEmpty() ? QStringLiteral("unknown") : QFileInfo(d->executablePath).fileName();
+    setObjectName(QStringLiteral("Wayland client %1 (%2)").arg(executable).arg(d->pid));
+    DebugStatistics::self()->add(this);
 }
 
 ClientConnection::~ClientConnection() = default;
@@ -175,6 +194,31 @@ QString ClientConnection::securityContextAppId() const
 {
     return d->securityContextAppId;
 }
+
+quint64 ClientConnection::requestCount() const
+{
+    return d->requestCount;
+}
+
+quint64 ClientConnection::requestBytes() const
+{
+    return d->requestBytes;
+}
+
+uint ClientConnection::requestsPerSecond() const
+{
+    return d->requestRate.rate(std::chrono::steady_clock::now());
+}
+
+uint ClientConnection::commitsPerSecond() const
+{
+    return d->commitRate.rate(std::chrono::steady_clock::now());
+}
+
+qint64 ClientConnection::handlerTime() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(d->handlerTime).count();
+}
 }
 
 #include "moc_clientconnection.cpp"
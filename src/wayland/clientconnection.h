@@ -31,6 +31,26 @@ class Display;
 class KWIN_EXPORT ClientConnection : public QObject
 {
     Q_OBJECT
+    /**
+     * The number of requests the client has sent.
+     */
+    Q_PROPERTY(quint64 requestCount READ requestCount)
+    /**
+     * The size of the requests the client has sent, in bytes. File descriptors are not included.
+     */
+    Q_PROPERTY(quint64 requestBytes READ requestBytes)
+    /**
+     * The number of requests the client has sent in the last second.
+     */
+    Q_PROPERTY(uint requestsPerSecond READ requestsPerSecond)
+    /**
+     * The number of surface commits the client has sent in the last second.
+     */
+    Q_PROPERTY(uint commitsPerSecond READ commitsPerSecond)
+    /**
+     * The time spent handling the requests of the client, in microseconds.
+     */
+    Q_PROPERTY(qint64 handlerTime READ handlerTime)
 public:
     virtual ~ClientConnection();
 
@@ -127,6 +147,12 @@ public:
     void setSecurityContextAppId(const QString &appId);
     QString securityContextAppId() const;
 
+    quint64 requestCount() const;
+    quint64 requestBytes() const;
+    uint requestsPerSecond() const;
+    uint commitsPerSecond() const;
+    qint64 handlerTime() const;
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the client is about to be destroyed.
@@ -141,6 +167,7 @@ Q_SIGNALS:
 
 private:
     friend class Display;
+    friend class ClientConnectionPrivate;
     explicit ClientConnection(wl_client *c, Display *parent);
     std::unique_ptr<ClientConnectionPrivate> d;
 };
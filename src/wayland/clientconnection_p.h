@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2014 Martin Gräßlin <mgraesslin@kde.org>
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QList>
+#include <QString>
+
+#include <wayland-server-core.h>
+
+#include <chrono>
+
+#include <sys/types.h>
+
+namespace KWin
+{
+class ClientConnection;
+class Display;
+
+/**
+ * Counts events over one second long windows, the rate is the count of the last complete window.
+ */
+class KWIN_EXPORT RateCounter
+{
+public:
+    void add(std::chrono::steady_clock::time_point timestamp);
+    uint rate(std::chrono::steady_clock::time_point timestamp) const;
+
+private:
+    std::chrono::steady_clock::time_point m_windowStart;
+    uint m_current = 0;
+    uint m_previous = 0;
+};
+
+class ClientConnectionPrivate
+{
+public:
+    static ClientConnectionPrivate *get(ClientConnection *connection);
+
+    ClientConnectionPrivate(wl_client *c, Display *display, ClientConnection *q);
+    ~ClientConnectionPrivate();
+
+    void accountRequest(quint32 size, bool commit, std::chrono::steady_clock::time_point timestamp);
+
+    wl_client *client;
+    Display *display;
+    pid_t pid = 0;
+    uid_t user = 0;
+    gid_t group = 0;
+    QString executablePath;
+    QString securityContextAppId;
+    qreal scaleOverride = 1.0;
+
+    quint64 requestCount = 0;
+    quint64 requestBytes = 0;
+    std::chrono::nanoseconds handlerTime = std::chrono::nanoseconds::zero();
+    RateCounter requestRate;
+    RateCounter commitRate;
+
+private:
+    static void destroyListenerCallback(wl_listener *listener, void *data);
+    static void destroyLateListenerCallback(wl_listener *listener, void *data);
+    ClientConnection *q;
+    wl_listener destroyListener;
+    wl_listener destroyLateListener;
+    static QList<ClientConnectionPrivate *> s_allClients;
+};
+
+} // namespace KWin
@@ -5,6 +5,7 @@
     SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
 */
 #include "display.h"
+#include "clientconnection_p.h"
 #include "display_p.h"
 #include "linuxdmabufv1clientbuffer_p.h"
 #include "output.h"
@@ -20,6 +21,8 @@
 #include <QDebug>
 #include <QRect>
 
+#include <wayland-server-protocol.h>
+
 namespace KWin
 {
 DisplayPrivate *DisplayPrivate::get(Display *display)
@@ -38,17 +41,99 @@ void DisplayPrivate::registerSocketName(const QString &socketName)
     Q_EMIT q->socketNamesChanged();
 }
 
+void DisplayPrivate::finishRequest(std::chrono::steady_clock::time_point timestamp)
+{
+    if (requestClient) {
+        ClientConnectionPrivate::get(requestClient)->handlerTime += timestamp - requestStart;
+        requestClient = nullptr;
+    }
+}
+
+static quint32 alignedSize(size_t size)
+{
+    return (size + 3) & ~size_t(3);
+}
+
+/**
+ * Returns the size of the given @a message on the wire. File descriptors are sent out of band,
+ * so they don't contribute to it.
+ */
+static quint32 messageSize(const wl_protocol_logger_message *message)
+{
+    quint32 size = 2 * sizeof(uint32_t);
+    int argument = 0;
+    for (const char *type = message->message->signature; *type; ++type) {
+        switch (*type) {
+        case 'i':
+        case 'u':
+        case 'f':
+        case 'o':
+        case 'n':
+            size += sizeof(uint32_t);
+            argument++;
+            break;
+        case 's':
+            size += sizeof(uint32_t);
+            if (const char *string = message->arguments[argument].s) {
+                size += alignedSize(strlen(string) + 1);
+            }
+            argument++;
+            break;
+        case 'a':
+            size += sizeof(uint32_t);
+            if (const wl_array *array = message->arguments[argument].a) {
+                size += alignedSize(array->size);
+            }
+            argument++;
+            break;
+        case 'h':
+            argument++;
+            break;
+        default:
+            // the nullability marker and the version number
+            break;
+        }
+    }
+    return size;
+}
+
+static bool isCommit(const wl_protocol_logger_message *message)
+{
+    return wl_resource_get_class(message->resource) == wl_surface_interface.name
+        && strcmp(message->message->name, "commit") == 0;
+}
+
+void DisplayPrivate::logProtocolMessage(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message)
+{
+    if (type != WL_PROTOCOL_LOGGER_REQUEST) {
+        return;
+    }
+
+    // The logger is called right before the request handler. There is no hook after the handler,
+    // so the handler is considered finished when the next request arrives or the dispatch ends.
+    auto d = static_cast<DisplayPrivate *>(userData);
+    const auto timestamp = std::chrono::steady_clock::now();
+    d->finishRequest(timestamp);
+
+    ClientConnection *connection = d->q->getConnection(wl_resource_get_client(message->resource));
+    ClientConnectionPrivate::get(connection)->accountRequest(messageSize(message), isCommit(message), timestamp);
+    d->requestClient = connection;
+    d->requestStart = timestamp;
+}
+
 Display::Display(QObject *parent)
     : QObject(parent)
     , d(new DisplayPrivate(this))
 {
     d->display = wl_display_create();
     d->loop = wl_display_get_event_loop(d->display);
+    d->protocolLogger = wl_display_add_protocol_logger(d->display, DisplayPrivate::logProtocolMessage, d.get());
 }
 
 Display::~Display()
 {
     wl_display_destroy_clients(d->display);
+    wl_protocol_logger_destroy(d->protocolLogger);
     wl_display_destroy(d->display);
 }
 
@@ -117,6 +202,7 @@ void Display::dispatchEvents()
     if (wl_event_loop_dispatch(d->loop, 0) != 0) {
         qCWarning(KWIN_CORE) << "Error on dispatching Wayland event loop";
     }
+    d->finishRequest(std::chrono::steady_clock::now());
 }
 
 void Display::flush()
@@ -199,20 +285,22 @@ QList<SeatInterface *> Display::seats() const
 ClientConnection *Display::getConnection(wl_client *client)
 {
     Q_ASSERT(client);
-    auto it = std::find_if(d->clients.constBegin(), d->clients.constEnd(), [client](ClientConnection *c) {
-        return c->client() == client;
-    });
-    if (it != d->clients.constEnd()) {
-        return *it;
+    if (ClientConnection *connection = d->clientsByHandle.value(client)) {
+        return connection;
     }
     // no ConnectionData yet, create it
     auto c = new ClientConnection(client, this);
     d->clients << c;
+    d->clientsByHandle.insert(client, c);
     connect(c, &ClientConnection::disconnected, this, [this](ClientConnection *c) {
         const int index = d->clients.indexOf(c);
         Q_ASSERT(index != -1);
         d->clients.remove(index);
         Q_ASSERT(d->clients.indexOf(c) == -1);
+        d->clientsByHandle.remove(c->client());
+        if (d->requestClient == c) {
+            d->requestClient = nullptr;
+        }
         Q_EMIT clientDisconnected(c);
     });
     Q_EMIT clientConnected(c);
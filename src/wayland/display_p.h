@@ -10,10 +10,13 @@
 #include <wayland-server-core.h>
 
 #include "utils/filedescriptor.h"
+#include <QHash>
 #include <QList>
 #include <QSocketNotifier>
 #include <QString>
 
+#include <chrono>
+
 struct wl_resource;
 
 namespace KWin
@@ -31,6 +34,9 @@ public:
     DisplayPrivate(Display *q);
 
     void registerSocketName(const QString &socketName);
+    void finishRequest(std::chrono::steady_clock::time_point timestamp);
+
+    static void logProtocolMessage(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message);
 
     Display *q;
     QSocketNotifier *socketNotifier = nullptr;
@@ -41,7 +47,13 @@ public:
     QList<OutputDeviceV2Interface *> outputdevicesV2;
     QList<SeatInterface *> seats;
     QList<ClientConnection *> clients;
+    QHash<wl_client *, ClientConnection *> clientsByHandle;
     QStringList socketNames;
+
+    wl_protocol_logger *protocolLogger = nullptr;
+    // The client whose request is being handled, and when the handling started
+    ClientConnection *requestClient = nullptr;
+    std::chrono::steady_clock::time_point requestStart;
 };
 
 /**
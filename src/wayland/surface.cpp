@@ -564,6 +564,15 @@ QRectF SurfaceInterfacePrivate::computeBufferSourceBox() const
     return current->bufferTransform.inverted().map(box, bounds);
 }
 
+// Surfaces are committed often, keep a few states around instead of allocating new ones
+static constexpr size_t s_maxRecycledStates = 32;
+
+static std::vector<std::unique_ptr<SurfaceState>> &recycledStates()
+{
+    static std::vector<std::unique_ptr<SurfaceState>> states;
+    return states;
+}
+
 SurfaceState::SurfaceState()
 {
     wl_list_init(&frameCallbacks);
@@ -579,6 +588,43 @@ SurfaceState::~SurfaceState()
     }
 }
 
+std::unique_ptr<SurfaceState> SurfaceState::acquire()
+{
+    auto &states = recycledStates();
+    if (states.empty()) {
+        return std::make_unique<SurfaceState>();
+    }
+    std::unique_ptr<SurfaceState> state = std::move(states.back());
+    states.pop_back();
+    return state;
+}
+
+void SurfaceState::recycle(std::unique_ptr<SurfaceState> state)
+{
+    auto &states = recycledStates();
+    if (states.size() < s_maxRecycledStates) {
+        state->reset();
+        if (states.capacity() == 0) {
+            states.reserve(s_maxRecycledStates);
+        }
+        states.push_back(std::move(state));
+    }
+}
+
+void SurfaceState::reset()
+{
+    wl_resource *resource;
+    wl_resource *tmp;
+    wl_resource_for_each_safe (resource, tmp, &frameCallbacks) {
+        wl_resource_destroy(resource);
+    }
+
+    // Constructing a SurfaceState doesn't allocate memory, so this is cheap and picks up
+    // the defaults of every field. The list head is copied bitwise, it has to point to us.
+    *this = SurfaceState();
+    wl_list_init(&frameCallbacks);
+}
+
 void SurfaceState::mergeInto(SurfaceState *target)
 {
     target->serial = serial;
@@ -653,10 +699,11 @@ void SurfaceState::mergeInto(SurfaceState *target)
         target->presentationFeedback = std::move(presentationFeedback);
     }
 
-    *this = SurfaceState{};
+    // The frame callbacks belong to the target now
+    wl_list_init(&frameCallbacks);
+    reset();
     serial = target->serial;
     subsurface = target->subsurface;
-    wl_list_init(&frameCallbacks);
 }
 
 void SurfaceInterfacePrivate::applyState(SurfaceState *next)
@@ -37,12 +37,35 @@ struct SurfaceState
 
     void mergeInto(SurfaceState *target);
 
+    /**
+     * Resets the state to the default values, the frame callbacks are destroyed.
+     */
+    void reset();
+
+    /**
+     * Returns an unused state, recycled ones are preferred over allocating new states.
+     */
+    static std::unique_ptr<SurfaceState> acquire();
+    /**
+     * Resets the given @a state and keeps it around so it can be handed out again by acquire().
+     */
+    static void recycle(std::unique_ptr<SurfaceState> state);
+
+    /**
+     * The infinite input region is shared by all states, creating a region allocates memory.
+     */
+    static const QRegion &defaultInputRegion()
+    {
+        static const QRegion region = infiniteRegion();
+        return region;
+    }
+
     quint32 serial = 0;
 
     QRegion damage = QRegion();
     QRegion bufferDamage = QRegion();
     QRegion opaque = QRegion();
-    QRegion input = infiniteRegion();
+    QRegion input = defaultInputRegion();
     bool inputIsSet = false;
     bool opaqueIsSet = false;
     bool bufferIsSet = false;
@@ -5,81 +5,170 @@
 */
 
 #include "wayland/transaction.h"
+#include "utils/common.h"
 #include "utils/filedescriptor.h"
 #include "wayland/subcompositor.h"
 #include "wayland/surface_p.h"
 #include "wayland/transaction_p.h"
 
+#include <linux/dma-buf.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+
+#include <cerrno>
+#include <cstring>
+
 namespace KWin
 {
 
-TransactionDmaBufLocker *TransactionDmaBufLocker::get(GraphicsBuffer *buffer)
+static FileDescriptor exportSyncFile(const FileDescriptor &dmabuf)
+{
+#ifdef DMA_BUF_IOCTL_EXPORT_SYNC_FILE
+    dma_buf_export_sync_file request{
+        .flags = DMA_BUF_SYNC_READ,
+        .fd = -1,
+    };
+    if (ioctl(dmabuf.get(), DMA_BUF_IOCTL_EXPORT_SYNC_FILE, &request) == 0) {
+        return FileDescriptor(request.fd);
+    }
+#endif
+    // Without an explicit fence, poll the dmabuf itself for its implicit fences
+    return dmabuf.duplicate();
+}
+
+TransactionFenceWaiter *TransactionFenceWaiter::self()
+{
+    static TransactionFenceWaiter *waiter = new TransactionFenceWaiter();
+    return waiter;
+}
+
+TransactionFenceWaiter::TransactionFenceWaiter()
+    : m_epollFd(epoll_create1(EPOLL_CLOEXEC))
 {
-    static QHash<GraphicsBuffer *, TransactionDmaBufLocker *> lockers;
-    if (auto it = lockers.find(buffer); it != lockers.end()) {
-        return *it;
+    if (!m_epollFd.isValid()) {
+        qCWarning(KWIN_CORE) << "Failed to create an epoll instance for transaction fences:" << strerror(errno);
+        return;
     }
+    m_notifier = std::make_unique<QSocketNotifier>(m_epollFd.get(), QSocketNotifier::Read);
+    connect(m_notifier.get(), &QSocketNotifier::activated, this, &TransactionFenceWaiter::dispatch);
+}
 
+void TransactionFenceWaiter::add(Transaction *transaction, GraphicsBuffer *buffer)
+{
     const DmaBufAttributes *attributes = buffer->dmabufAttributes();
-    if (!attributes) {
-        return nullptr;
+    if (!attributes || !m_epollFd.isValid()) {
+        return;
     }
 
-    auto locker = new TransactionDmaBufLocker(attributes);
-    lockers[buffer] = locker;
-    QObject::connect(buffer, &QObject::destroyed, [buffer]() {
-        delete lockers.take(buffer);
-    });
+    for (int i = 0; i < attributes->planeCount; ++i) {
+        FileDescriptor fence = exportSyncFile(attributes->fd[i]);
+        if (!fence.isValid() || fence.isReadable()) {
+            continue;
+        }
+
+        const int fd = fence.get();
+        epoll_event event{
+            .events = EPOLLIN,
+            .data = {.fd = fd},
+        };
+        if (epoll_ctl(m_epollFd.get(), EPOLL_CTL_ADD, fd, &event) != 0) {
+            qCWarning(KWIN_CORE) << "Failed to wait for a transaction fence:" << strerror(errno);
+            continue;
+        }
 
-    return locker;
+        transaction->lock();
+        m_fences.emplace(fd, Fence{
+                                 .fd = std::move(fence),
+                                 .transaction = transaction,
+                             });
+    }
 }
 
-TransactionDmaBufLocker::TransactionDmaBufLocker(const DmaBufAttributes *attributes)
+void TransactionFenceWaiter::dispatch()
 {
-    for (int i = 0; i < attributes->planeCount; ++i) {
-        auto notifier = new QSocketNotifier(attributes->fd[i].get(), QSocketNotifier::Read);
-        notifier->setEnabled(false);
-        connect(notifier, &QSocketNotifier::activated, this, [this, notifier]() {
-            notifier->setEnabled(false);
-            m_pending.removeOne(notifier);
-            if (m_pending.isEmpty()) {
-                const auto transactions = m_transactions; // unlock() may destroy this
-                m_transactions.clear();
-                for (Transaction *transition : transactions) {
-                    transition->unlock();
-                }
+    QVarLengthArray<Transaction *, 32> ready;
+
+    epoll_event events[32];
+    int count;
+    do {
+        count = epoll_wait(m_epollFd.get(), events, std::size(events), 0);
+        for (int i = 0; i < count; ++i) {
+            const auto it = m_fences.find(events[i].data.fd);
+            if (it == m_fences.end()) {
+                continue;
             }
-        });
-        m_notifiers.emplace_back(notifier);
+            epoll_ctl(m_epollFd.get(), EPOLL_CTL_DEL, it->first, nullptr);
+            ready.append(it->second.transaction);
+            m_fences.erase(it);
+        }
+    } while (count == int(std::size(events)));
+
+    // Unlocking may apply the transactions, so do it only after all signaled fences are collected
+    for (Transaction *transaction : ready) {
+        transaction->unlock();
     }
 }
 
-void TransactionDmaBufLocker::add(Transaction *transition)
+static constexpr size_t s_maxRecycledTransactions = 32;
+
+namespace
+{
+struct RecycledTransactions
 {
-    if (arm()) {
-        transition->lock();
-        m_transactions.append(transition);
+    ~RecycledTransactions()
+    {
+        for (void *block : blocks) {
+            ::operator delete(block);
+        }
     }
+
+    std::vector<void *> blocks;
+};
 }
 
-bool TransactionDmaBufLocker::arm()
+static RecycledTransactions &recycledTransactions()
 {
-    if (!m_pending.isEmpty()) {
-        return true;
+    static RecycledTransactions transactions;
+    return transactions;
+}
+
+void *Transaction::operator new(size_t size)
+{
+    auto &blocks = recycledTransactions().blocks;
+    if (size != sizeof(Transaction) || blocks.empty()) {
+        return ::operator new(size);
     }
-    for (const auto &notifier : m_notifiers) {
-        if (!FileDescriptor::isReadable(notifier->socket())) {
-            notifier->setEnabled(true);
-            m_pending.append(notifier.get());
-        }
+    void *block = blocks.back();
+    blocks.pop_back();
+    return block;
+}
+
+void Transaction::operator delete(void *pointer, size_t size)
+{
+    auto &blocks = recycledTransactions().blocks;
+    if (size != sizeof(Transaction) || blocks.size() >= s_maxRecycledTransactions) {
+        ::operator delete(pointer);
+        return;
+    }
+    if (blocks.capacity() == 0) {
+        blocks.reserve(s_maxRecycledTransactions);
     }
-    return !m_pending.isEmpty();
+    blocks.push_back(pointer);
 }
 
 Transaction::Transaction()
 {
 }
 
+Transaction::~Transaction()
+{
+    for (TransactionEntry &entry : m_entries) {
+        if (entry.state) {
+            SurfaceState::recycle(std::move(entry.state));
+        }
+    }
+}
+
 void Transaction::lock()
 {
     m_locks++;
@@ -129,7 +218,7 @@ void Transaction::add(SurfaceInterface *surface)
         }
     }
 
-    auto state = std::make_unique<SurfaceState>();
+    auto state = SurfaceState::acquire();
     pending->mergeInto(state.get());
 
     m_entries.emplace_back(TransactionEntry{
@@ -150,8 +239,8 @@ void Transaction::amend(SurfaceInterface *surface, std::function<void(SurfaceSta
 
 void Transaction::merge(Transaction *other)
 {
-    for (size_t i = 0; i < other->m_entries.size(); ++i) {
-        m_entries.emplace_back(std::move(other->m_entries[i]));
+    for (TransactionEntry &entry : other->m_entries) {
+        m_entries.emplace_back(std::move(entry));
     }
     other->m_entries.clear();
 }
@@ -248,9 +337,7 @@ void Transaction::commit()
     for (TransactionEntry &entry : m_entries) {
         if (entry.state->bufferIsSet && entry.state->buffer) {
             // Avoid applying the transaction until all graphics buffers have become idle.
-            if (auto locker = TransactionDmaBufLocker::get(entry.state->buffer)) {
-                locker->add(this);
-            }
+            TransactionFenceWaiter::self()->add(this, entry.state->buffer);
         }
 
         if (entry.surface->firstTransaction()) {
@@ -9,6 +9,7 @@
 #include "core/graphicsbuffer.h"
 
 #include <QPointer>
+#include <QVarLengthArray>
 
 #include <functional>
 #include <memory>
@@ -61,6 +62,14 @@ class KWIN_EXPORT Transaction
 {
 public:
     Transaction();
+    ~Transaction();
+
+    /**
+     * Transactions are created for every surface commit, their memory is recycled rather than
+     * returned to the system allocator.
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *pointer, size_t size);
 
     /**
      * Locks the transaction. While the transaction is locked, it cannot be applied.
@@ -114,7 +123,8 @@ private:
     void apply();
     bool tryApply();
 
-    std::vector<TransactionEntry> m_entries;
+    // Most transactions affect a single surface
+    QVarLengthArray<TransactionEntry, 1> m_entries;
     int m_locks = 0;
 };
 
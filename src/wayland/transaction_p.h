@@ -7,30 +7,49 @@
 #pragma once
 
 #include "transaction.h"
+#include "utils/filedescriptor.h"
 
 #include <QObject>
 #include <QSocketNotifier>
 
+#include <unordered_map>
+
 namespace KWin
 {
 
-class TransactionDmaBufLocker : public QObject
+/**
+ * The TransactionFenceWaiter class keeps transactions locked until the graphics buffers
+ * attached to them are ready to be read.
+ *
+ * All fences are watched with a single epoll instance. The fences that signal at the same
+ * time are collected first and the corresponding transactions are unlocked in one pass.
+ */
+class TransactionFenceWaiter : public QObject
 {
     Q_OBJECT
 
 public:
-    static TransactionDmaBufLocker *get(GraphicsBuffer *buffer);
+    static TransactionFenceWaiter *self();
 
-    void add(Transaction *transaction);
+    /**
+     * Locks the given @a transaction until the rendering to the @a buffer has finished.
+     */
+    void add(Transaction *transaction, GraphicsBuffer *buffer);
 
 private:
-    explicit TransactionDmaBufLocker(const DmaBufAttributes *attributes);
+    TransactionFenceWaiter();
+
+    void dispatch();
 
-    bool arm();
+    struct Fence
+    {
+        FileDescriptor fd;
+        Transaction *transaction;
+    };
 
-    QList<Transaction *> m_transactions;
-    QList<QSocketNotifier *> m_pending;
-    std::vector<std::unique_ptr<QSocketNotifier>> m_notifiers;
+    FileDescriptor m_epollFd;
+    std::unique_ptr<QSocketNotifier> m_notifier;
+    std::unordered_map<int, Fence> m_fences;
 };
 
 } // namespace KWin
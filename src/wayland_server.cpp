@@ -211,6 +211,7 @@ void WaylandServer::registerWindow(Window *window)
         connect(window, &Window::windowShown, this, &WaylandServer::windowAdded, Qt::SingleShotConnection);
     }
     m_windows << window;
+    m_windowsBySurface.insert(window->surface(), window);
 }
 
 void WaylandServer::registerXdgToplevelWindow(XdgToplevelWindow *window)
@@ -718,29 +719,25 @@ void WaylandServer::destroyInputMethodConnection()
 void WaylandServer::removeWindow(Window *c)
 {
     m_windows.removeAll(c);
+    // The surface may be already gone, so the window can't be looked up by it
+    m_windowsBySurface.removeIf([c](const auto &it) {
+        return it.value() == c;
+    });
     if (c->readyForPainting()) {
         Q_EMIT windowRemoved(c);
     }
 }
 
-static Window *findWindowInList(const QList<Window *> &windows, const SurfaceInterface *surface)
-{
-    auto it = std::find_if(windows.begin(), windows.end(), [surface](Window *w) {
-        return w->surface() == surface;
-    });
-    if (it == windows.end()) {
-        return nullptr;
-    }
-    return *it;
-}
-
 Window *WaylandServer::findWindow(const SurfaceInterface *surface) const
 {
     if (!surface) {
         return nullptr;
     }
-    if (Window *c = findWindowInList(m_windows, surface)) {
-        return c;
+    // A destroyed surface can leave a stale entry behind until its window is removed,
+    // make sure that the window still refers to the surface
+    Window *window = m_windowsBySurface.value(surface);
+    if (window && window->surface() == surface) {
+        return window;
     }
     return nullptr;
 }
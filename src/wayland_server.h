@@ -284,6 +284,7 @@ private:
     XwaylandShellV1Interface *m_xwaylandShell = nullptr;
     PresentationTime *m_presentationTime = nullptr;
     QList<Window *> m_windows;
+    QHash<const SurfaceInterface *, Window *> m_windowsBySurface;
     InitializationFlags m_initFlags;
     QHash<Output *, OutputInterface *> m_waylandOutputs;
     QHash<Output *, OutputDeviceV2Interface *> m_waylandOutputDevices;
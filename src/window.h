@@ -1330,7 +1330,11 @@ Q_SIGNALS:
     void stackingOrderChanged();
     void shadeChanged();
     void opacityChanged(KWin::Window *window, qreal oldOpacity);
-    void damaged(KWin::Window *window);
+    /**
+     * This signal is emitted when the given @a region of the window has been damaged. The
+     * region is in the global logical coordinates.
+     */
+    void damaged(KWin::Window *window, const QRegion &region);
     void inputTransformationChanged();
     void closed();
     void windowShown(KWin::Window *window);
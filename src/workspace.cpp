@@ -38,6 +38,7 @@
 #include "rules.h"
 #include "screenedge.h"
 #include "scripting/scripting.h"
+#include "snapindex.h"
 #include "syncalarmx11filter.h"
 #include "tiles/tilemanager.h"
 #include "x11window.h"
@@ -73,6 +74,8 @@
 #include <QMetaProperty>
 // xcb
 #include <xcb/xinerama.h>
+// std
+#include <optional>
 
 namespace KWin
 {
@@ -112,6 +115,7 @@ Workspace::Workspace()
     , m_outputConfigStore(std::make_unique<OutputConfigurationStore>())
     , m_lidSwitchTracker(std::make_unique<LidSwitchTracker>())
     , m_orientationSensor(std::make_unique<OrientationSensor>())
+    , m_snapIndex(std::make_unique<SnapIndex>())
 {
     _self = this;
 
@@ -657,6 +661,57 @@ void Workspace::removeFromStack(Window *window)
     }
 }
 
+template<typename Key, typename T>
+static void removeIndexEntry(QHash<Key, T *> &index, const Key &key, const T *window)
+{
+    // Another window may have been registered with the same key in the meantime
+    auto it = index.find(key);
+    if (it != index.end() && it.value() == window) {
+        index.erase(it);
+    }
+}
+
+void Workspace::addToWindowIndex(Window *window)
+{
+    m_windowsByInternalId.insert(window->internalId(), window);
+
+    m_snapIndex->insert(window, window->frameGeometry());
+    connect(window, &Window::frameGeometryChanged, this, [this, window]() {
+        m_snapIndex->insert(window, window->frameGeometry());
+    });
+
+    if (X11Window *x11Window = qobject_cast<X11Window *>(window)) {
+        if (x11Window->isUnmanaged()) {
+            m_unmanagedWindowsById.insert(x11Window->window(), x11Window);
+        } else {
+            m_x11WindowsById.insert(x11Window->window(), x11Window);
+            m_x11WindowsByWrapperId.insert(x11Window->wrapperId(), x11Window);
+            m_x11WindowsByFrameId.insert(x11Window->frameId(), x11Window);
+        }
+    } else if (InternalWindow *internalWindow = qobject_cast<InternalWindow *>(window)) {
+        m_internalWindowsByHandle.insert(internalWindow->handle(), internalWindow);
+    }
+}
+
+void Workspace::removeFromWindowIndex(Window *window)
+{
+    removeIndexEntry(m_windowsByInternalId, window->internalId(), window);
+    m_snapIndex->remove(window);
+    disconnect(window, &Window::frameGeometryChanged, this, nullptr);
+
+    if (X11Window *x11Window = qobject_cast<X11Window *>(window)) {
+        if (x11Window->isUnmanaged()) {
+            removeIndexEntry(m_unmanagedWindowsById, x11Window->window(), x11Window);
+        } else {
+            removeIndexEntry(m_x11WindowsById, x11Window->window(), x11Window);
+            removeIndexEntry(m_x11WindowsByWrapperId, x11Window->wrapperId(), x11Window);
+            removeIndexEntry(m_x11WindowsByFrameId, x11Window->frameId(), x11Window);
+        }
+    } else if (InternalWindow *internalWindow = qobject_cast<InternalWindow *>(window)) {
+        removeIndexEntry(m_internalWindowsByHandle, internalWindow->handle(), internalWindow);
+    }
+}
+
 X11Window *Workspace::createX11Window(xcb_window_t windowId, bool is_mapped)
 {
     StackingUpdatesBlocker blocker(this);
@@ -701,6 +756,7 @@ void Workspace::addX11Window(X11Window *window)
     }
     Q_ASSERT(!m_windows.contains(window));
     m_windows.append(window);
+    addToWindowIndex(window);
     addToStack(window);
     if (window->hasStrut()) {
         updateClientArea(); // This cannot be in manage(), because the window got added only now
@@ -726,6 +782,7 @@ void Workspace::addUnmanaged(X11Window *window)
 {
     Q_ASSERT(!m_windows.contains(window));
     m_windows.append(window);
+    addToWindowIndex(window);
     addToStack(window);
     updateStackingOrder(true);
     Q_EMIT windowAdded(window);
@@ -748,6 +805,7 @@ void Workspace::removeUnmanaged(X11Window *window)
 {
     Q_ASSERT(m_windows.contains(window));
     m_windows.removeOne(window);
+    removeFromWindowIndex(window);
     removeFromStack(window);
     updateStackingOrder();
     Q_EMIT windowRemoved(window);
@@ -790,6 +848,7 @@ void Workspace::addWaylandWindow(Window *window)
     }
     Q_ASSERT(!m_windows.contains(window));
     m_windows.append(window);
+    addToWindowIndex(window);
     addToStack(window);
 
     updateStackingOrder(true);
@@ -822,6 +881,7 @@ void Workspace::removeWindow(Window *window)
     }
 
     m_windows.removeAll(window);
+    removeFromWindowIndex(window);
     if (window == m_delayFocusWindow) {
         cancelDelayFocus();
     }
@@ -1915,27 +1975,23 @@ X11Window *Workspace::findUnmanaged(std::function<bool(const X11Window *)> func)
 
 X11Window *Workspace::findUnmanaged(xcb_window_t w) const
 {
-    return findUnmanaged([w](const X11Window *u) {
-        return u->window() == w;
-    });
+    return m_unmanagedWindowsById.value(w);
 }
 
 X11Window *Workspace::findClient(Predicate predicate, xcb_window_t w) const
 {
+    if (w == XCB_WINDOW_NONE) {
+        return nullptr;
+    }
     switch (predicate) {
     case Predicate::WindowMatch:
-        return findClient([w](const X11Window *c) {
-            return c->window() == w;
-        });
+        return m_x11WindowsById.value(w);
     case Predicate::WrapperIdMatch:
-        return findClient([w](const X11Window *c) {
-            return c->wrapperId() == w;
-        });
+        return m_x11WindowsByWrapperId.value(w);
     case Predicate::FrameIdMatch:
-        return findClient([w](const X11Window *c) {
-            return c->frameId() == w;
-        });
+        return m_x11WindowsByFrameId.value(w);
     case Predicate::InputIdMatch:
+        // The input window comes and goes with the decoration, it's not worth indexing
         return findClient([w](const X11Window *c) {
             return c->inputId() == w;
         });
@@ -1950,9 +2006,7 @@ Window *Workspace::findWindow(std::function<bool(const Window *)> func) const
 
 Window *Workspace::findWindow(const QUuid &internalId) const
 {
-    return findWindow([internalId](const KWin::Window *l) -> bool {
-        return internalId == l->internalId();
-    });
+    return m_windowsByInternalId.value(internalId);
 }
 
 void Workspace::forEachWindow(std::function<void(Window *)> func)
@@ -1976,14 +2030,7 @@ Window *Workspace::findInternal(QWindow *w) const
     if (kwinApp()->operationMode() == Application::OperationModeX11) {
         return findUnmanaged(w->winId());
     }
-    for (Window *window : m_windows) {
-        if (InternalWindow *internal = qobject_cast<InternalWindow *>(window)) {
-            if (internal->handle() == w) {
-                return internal;
-            }
-        }
-    }
-    return nullptr;
+    return m_internalWindowsByHandle.value(w);
 }
 
 void Workspace::setWasUserInteraction()
@@ -2012,6 +2059,7 @@ void Workspace::addInternalWindow(InternalWindow *window)
 {
     Q_ASSERT(!m_windows.contains(window));
     m_windows.append(window);
+    addToWindowIndex(window);
     addToStack(window);
 
     setupWindowConnections(window);
@@ -2029,6 +2077,7 @@ void Workspace::addInternalWindow(InternalWindow *window)
 void Workspace::removeInternalWindow(InternalWindow *window)
 {
     m_windows.removeOne(window);
+    removeFromWindowIndex(window);
 
     updateStackingOrder();
     Q_EMIT windowRemoved(window);
@@ -2298,17 +2347,16 @@ void Workspace::updateClientArea()
 {
     const QList<VirtualDesktop *> desktops = VirtualDesktopManager::self()->desktops();
 
-    QHash<const VirtualDesktop *, QRectF> workAreas;
-    QHash<const VirtualDesktop *, StrutRects> restrictedAreas;
-    QHash<const VirtualDesktop *, QHash<const Output *, QRectF>> screenAreas;
-
-    for (const VirtualDesktop *desktop : desktops) {
-        workAreas[desktop] = m_geometry;
-
-        for (const Output *output : std::as_const(m_outputs)) {
-            screenAreas[desktop][output] = output->fractionalGeometry();
-        }
-    }
+    // The effect of a strut doesn't depend on the virtual desktop, so compute it only once
+    // rather than for every desktop the window is on.
+    struct StrutContribution
+    {
+        std::optional<QRectF> workArea;
+        StrutRects restrictedArea;
+        QHash<const Output *, QRectF> screenAreas;
+    };
+    std::vector<StrutContribution> contributions;
+    QHash<const VirtualDesktop *, QList<qsizetype>> desktopContributions;
 
     for (Window *window : std::as_const(m_windows)) {
         if (!window->hasStrut()) {
@@ -2341,31 +2389,91 @@ void Workspace::updateClientArea()
             }
         }
 
+        StrutContribution contribution;
         // Ignore offscreen xinerama struts. These interfere with the larger monitors on the setup
         // and should be ignored so that applications that use the work area to work out where
         // windows can go can use the entire visible area of the larger monitors.
         // This goes against the EWMH description of the work area but it is a toss up between
         // having unusable sections of the screen (Which can be quite large with newer monitors)
         // or having some content appear offscreen (Relatively rare compared to other).
-        bool hasOffscreenStrut = hasOffscreenXineramaStrut(window);
+        if (!hasOffscreenXineramaStrut(window)) {
+            contribution.workArea = r;
+        }
+        contribution.restrictedArea = strutRegion;
+        for (const Output *output : std::as_const(m_outputs)) {
+            contribution.screenAreas[output] = adjustClientArea(window, output->fractionalGeometry());
+        }
+
+        const qsizetype index = contributions.size();
+        contributions.push_back(std::move(contribution));
 
         const auto vds = window->isOnAllDesktops() ? desktops : window->desktops();
         for (VirtualDesktop *vd : vds) {
-            if (!hasOffscreenStrut) {
-                workAreas[vd] &= r;
+            desktopContributions[vd].append(index);
+        }
+    }
+
+    QHash<const VirtualDesktop *, QRectF> workAreas;
+    QHash<const VirtualDesktop *, StrutRects> restrictedAreas;
+    QHash<const VirtualDesktop *, QHash<const Output *, QRectF>> screenAreas;
+
+    // Usually most desktops have the same struts, e.g. panels that are on all desktops. Their
+    // areas are the same, so they are computed only once.
+    struct DesktopAreas
+    {
+        QRectF workArea;
+        StrutRects restrictedArea;
+        QHash<const Output *, QRectF> screenAreas;
+    };
+    QHash<QList<qsizetype>, DesktopAreas> cache;
+
+    for (const VirtualDesktop *desktop : desktops) {
+        const QList<qsizetype> indices = desktopContributions.value(desktop);
+
+        auto it = cache.find(indices);
+        if (it == cache.end()) {
+            DesktopAreas areas;
+            areas.workArea = m_geometry;
+            for (const Output *output : std::as_const(m_outputs)) {
+                areas.screenAreas[output] = output->fractionalGeometry();
             }
-            restrictedAreas[vd] += strutRegion;
-            for (Output *output : std::as_const(m_outputs)) {
-                const auto geo = screenAreas[vd][output].intersected(adjustClientArea(window, output->fractionalGeometry()));
-                // ignore the geometry if it results in the screen getting removed completely
-                if (!geo.isEmpty()) {
-                    screenAreas[vd][output] = geo;
+
+            for (const qsizetype index : indices) {
+                const StrutContribution &contribution = contributions[index];
+                if (contribution.workArea) {
+                    areas.workArea &= *contribution.workArea;
+                }
+                areas.restrictedArea += contribution.restrictedArea;
+                for (const Output *output : std::as_const(m_outputs)) {
+                    const auto geo = areas.screenAreas[output].intersected(contribution.screenAreas[output]);
+                    // ignore the geometry if it results in the screen getting removed completely
+                    if (!geo.isEmpty()) {
+                        areas.screenAreas[output] = geo;
+                    }
                 }
             }
+
+            it = cache.insert(indices, areas);
+        }
+
+        workAreas[desktop] = it->workArea;
+        screenAreas[desktop] = it->screenAreas;
+        if (!indices.isEmpty()) {
+            restrictedAreas[desktop] = it->restrictedArea;
         }
     }
 
     if (m_workAreas != workAreas || m_restrictedAreas != restrictedAreas || m_screenAreas != screenAreas) {
+        // Only the windows on the desktops whose areas have changed need to be checked
+        QSet<const VirtualDesktop *> changedDesktops;
+        for (const VirtualDesktop *desktop : desktops) {
+            if (m_workAreas.value(desktop) != workAreas.value(desktop)
+                || m_restrictedAreas.value(desktop) != restrictedAreas.value(desktop)
+                || m_screenAreas.value(desktop) != screenAreas.value(desktop)) {
+                changedDesktops.insert(desktop);
+            }
+        }
+
         m_workAreas = workAreas;
         m_screenAreas = screenAreas;
 
@@ -2381,9 +2489,17 @@ void Workspace::updateClientArea()
             }
         }
 
-        for (auto it = m_windows.constBegin(); it != m_windows.constEnd(); ++it) {
-            if ((*it)->isClient()) {
-                (*it)->checkWorkspacePosition();
+        if (!changedDesktops.isEmpty()) {
+            VirtualDesktop *currentDesktop = VirtualDesktopManager::self()->currentDesktop();
+            for (auto it = m_windows.constBegin(); it != m_windows.constEnd(); ++it) {
+                if (!(*it)->isClient()) {
+                    continue;
+                }
+                // checkWorkspacePosition() looks only at the areas of this desktop
+                const VirtualDesktop *desktop = (*it)->isOnCurrentDesktop() || (*it)->desktops().isEmpty() ? currentDesktop : (*it)->desktops().constLast();
+                if (changedDesktops.contains(desktop)) {
+                    (*it)->checkWorkspacePosition();
+                }
             }
         }
 
@@ -2654,7 +2770,9 @@ QPointF Workspace::adjustWindowPosition(Window *window, QPointF pos, bool unrest
         // windows snap
         const int windowSnapZone = options->windowSnapZone() * snapAdjust;
         if (windowSnapZone > 0) {
-            for (auto l = m_windows.constBegin(); l != m_windows.constEnd(); ++l) {
+            // Only the windows with an edge close to an edge of the moved window can be snapped to
+            const QList<Window *> candidates = m_snapIndex->candidates({qreal(cx), qreal(rx)}, {qreal(cy), qreal(ry)}, windowSnapZone);
+            for (auto l = candidates.constBegin(); l != candidates.constEnd(); ++l) {
                 if ((*l) == window) {
                     continue;
                 }
@@ -2847,7 +2965,10 @@ QRectF Workspace::adjustWindowSize(Window *window, QRectF moveResizeGeom, Gravit
         if (snap) {
             deltaX = int(snap);
             deltaY = int(snap);
-            for (auto l = m_windows.constBegin(); l != m_windows.constEnd(); ++l) {
+            // The resized edges can move to the edge of another window while snapping, so
+            // the windows close to those edges have to be looked at as well
+            const QList<Window *> candidates = m_snapIndex->candidates({newcx, newrx}, {newcy, newry}, snap, SnapIndex::Reach::Transitive);
+            for (auto l = candidates.constBegin(); l != candidates.constEnd(); ++l) {
                 if ((*l)->isOnCurrentDesktop() && !(*l)->isMinimized() && !(*l)->isUnmanaged()
                     && (*l) != window) {
                     lx = (*l)->x();
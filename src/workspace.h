@@ -18,9 +18,11 @@
 #include "sm.h"
 #include "utils/common.h"
 // Qt
+#include <QHash>
 #include <QList>
 #include <QStringList>
 #include <QTimer>
+#include <QUuid>
 // std
 #include <functional>
 #include <memory>
@@ -68,6 +70,7 @@ enum class Predicate;
 class Outline;
 class RuleBook;
 class ScreenEdges;
+class SnapIndex;
 #if KWIN_BUILD_ACTIVITIES
 class Activities;
 #endif
@@ -587,6 +590,8 @@ private:
     void saveOldScreenSizes();
     void addToStack(Window *window);
     void removeFromStack(Window *window);
+    void addToWindowIndex(Window *window);
+    void removeFromWindowIndex(Window *window);
 
     /// This is the right way to create a new X11 window
     X11Window *createX11Window(xcb_window_t windowId, bool is_mapped);
@@ -649,6 +654,14 @@ private:
     QList<Window *> m_windows;
     QList<Window *> deleted;
 
+    // Lookup tables for the find*() helpers, they contain the same windows as m_windows
+    QHash<QUuid, Window *> m_windowsByInternalId;
+    QHash<xcb_window_t, X11Window *> m_x11WindowsById;
+    QHash<xcb_window_t, X11Window *> m_x11WindowsByWrapperId;
+    QHash<xcb_window_t, X11Window *> m_x11WindowsByFrameId;
+    QHash<xcb_window_t, X11Window *> m_unmanagedWindowsById;
+    QHash<QWindow *, InternalWindow *> m_internalWindowsByHandle;
+
     QList<Window *> unconstrained_stacking_order; // Topmost last
     QList<Window *> stacking_order; // Topmost last
     QList<xcb_window_t> manual_overlays; // Topmost last
@@ -728,6 +741,7 @@ private:
     std::unique_ptr<LidSwitchTracker> m_lidSwitchTracker;
     std::unique_ptr<OrientationSensor> m_orientationSensor;
     std::unique_ptr<DpmsInputEventFilter> m_dpmsFilter;
+    std::unique_ptr<SnapIndex> m_snapIndex;
 
 private:
     friend bool performTransiencyCheck();
@@ -11,6 +11,7 @@
 #include "dnd.h"
 #include "primary.h"
 #include "selection.h"
+#include "transfer.h"
 #include "xwayland.h"
 
 #include "atoms.h"
@@ -34,9 +35,13 @@ DataBridge::DataBridge()
 
 void DataBridge::init()
 {
+    m_transferStatistics = new TransferStatistics(this);
     m_clipboard = new Clipboard(atoms->clipboard, this);
+    m_clipboard->setTransferStatistics(m_transferStatistics);
     m_dnd = new Dnd(atoms->xdnd_selection, this);
+    m_dnd->setTransferStatistics(m_transferStatistics);
     m_primary = new Primary(atoms->primary, this);
+    m_primary->setTransferStatistics(m_transferStatistics);
     kwinApp()->installNativeEventFilter(this);
 }
 
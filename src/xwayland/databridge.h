@@ -25,6 +25,7 @@ namespace Xwl
 class Clipboard;
 class Dnd;
 class Primary;
+class TransferStatistics;
 enum class DragEventReply;
 
 /**
@@ -52,6 +53,7 @@ public:
 private:
     void init();
 
+    TransferStatistics *m_transferStatistics = nullptr;
     Clipboard *m_clipboard = nullptr;
     Dnd *m_dnd = nullptr;
     Primary *m_primary = nullptr;
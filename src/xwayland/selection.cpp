@@ -277,13 +277,24 @@ bool Selection::handlePropertyNotify(xcb_property_notify_event_t *event)
     return false;
 }
 
+void Selection::setTransferStatistics(TransferStatistics *statistics)
+{
+    m_transferStatistics = statistics;
+}
+
 void Selection::startTransferToWayland(xcb_atom_t target, qint32 fd)
 {
     // create new x to wl data transfer object
     auto *transfer = new TransferXtoWl(m_atom, target, fd, m_xSource->timestamp(), m_requestorWindow, this);
     m_xToWlTransfers << transfer;
+    if (m_transferStatistics) {
+        m_transferStatistics->transferStarted();
+    }
 
     connect(transfer, &TransferXtoWl::finished, this, [this, transfer]() {
+        if (m_transferStatistics) {
+            m_transferStatistics->transferFinished(transfer);
+        }
         Q_EMIT transferFinished(transfer->timestamp());
         transfer->deleteLater();
         m_xToWlTransfers.removeOne(transfer);
@@ -299,6 +310,9 @@ void Selection::startTransferToX(xcb_selection_request_event_t *event, qint32 fd
 
     connect(transfer, &TransferWltoX::selectionNotify, this, &Selection::sendSelectionNotify);
     connect(transfer, &TransferWltoX::finished, this, [this, transfer]() {
+        if (m_transferStatistics) {
+            m_transferStatistics->transferFinished(transfer);
+        }
         Q_EMIT transferFinished(transfer->timestamp());
 
         // TODO: serialize? see comment below.
@@ -313,6 +327,9 @@ void Selection::startTransferToX(xcb_selection_request_event_t *event, qint32 fd
 
     // add it to list of queued transfers
     m_wlToXTransfers.append(transfer);
+    if (m_transferStatistics) {
+        m_transferStatistics->transferStarted();
+    }
 
     // TODO: Do we need to serialize the transfers, or can we do
     //       them in parallel as we do it right now?
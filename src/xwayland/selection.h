@@ -21,6 +21,7 @@ namespace KWin
 {
 namespace Xwl
 {
+class TransferStatistics;
 class TransferWltoX;
 class TransferXtoWl;
 class WlSource;
@@ -65,6 +66,7 @@ public:
         return m_window;
     }
     void overwriteRequestorWindow(xcb_window_t window);
+    void setTransferStatistics(TransferStatistics *statistics);
 
 Q_SIGNALS:
     void transferFinished(xcb_timestamp_t eventTime);
@@ -126,6 +128,7 @@ private:
     QList<TransferWltoX *> m_wlToXTransfers;
     QList<TransferXtoWl *> m_xToWlTransfers;
     QTimer *m_timeoutTransfers = nullptr;
+    TransferStatistics *m_transferStatistics = nullptr;
 
     bool m_disownPending = false;
 
@@ -12,6 +12,7 @@
 #include "xwayland.h"
 
 #include "atoms.h"
+#include "utils/debugstatistics.h"
 #include "wayland/datadevice.h"
 #include "wayland/datasource.h"
 #include "wayland/seat.h"
@@ -23,6 +24,8 @@
 #include <xcb/xfixes.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include <xwayland_logging.h>
@@ -34,6 +37,80 @@ namespace Xwl
 
 // in Bytes: equals 64KB
 static const uint32_t s_incrChunkSize = 63 * 1024;
+// Stop reading from a Wayland source when the X client falls behind by this many chunks
+static const int s_maxBufferedChunks = 16;
+
+static bool isTemporaryError(int error)
+{
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+}
+
+TransferStatistics::TransferStatistics(QObject *parent)
+    : QObject(parent)
+{
+    setObjectName(QStringLiteral("Xwayland selection transfers"));
+    DebugStatistics::self()->add(this);
+}
+
+void TransferStatistics::transferStarted()
+{
+    m_activeTransfers++;
+}
+
+void TransferStatistics::transferFinished(const Transfer *transfer)
+{
+    m_activeTransfers--;
+    m_finishedTransfers++;
+
+    if (qobject_cast<const TransferWltoX *>(transfer)) {
+        m_bytesToX += transfer->bytesTransferred();
+    } else {
+        m_bytesToWayland += transfer->bytesTransferred();
+    }
+
+    if (transfer->latency() != -1) {
+        m_lastLatency = transfer->latency();
+        m_maxLatency = std::max(m_maxLatency, m_lastLatency);
+    }
+
+    const qint64 elapsed = std::max<qint64>(1, transfer->elapsed());
+    m_lastThroughput = transfer->bytesTransferred() * 1000 / elapsed / 1024;
+}
+
+int TransferStatistics::activeTransfers() const
+{
+    return m_activeTransfers;
+}
+
+quint64 TransferStatistics::finishedTransfers() const
+{
+    return m_finishedTransfers;
+}
+
+quint64 TransferStatistics::bytesToX() const
+{
+    return m_bytesToX;
+}
+
+quint64 TransferStatistics::bytesToWayland() const
+{
+    return m_bytesToWayland;
+}
+
+qint64 TransferStatistics::lastThroughput() const
+{
+    return m_lastThroughput;
+}
+
+qint64 TransferStatistics::lastLatency() const
+{
+    return m_lastLatency;
+}
+
+qint64 TransferStatistics::maxLatency() const
+{
+    return m_maxLatency;
+}
 
 Transfer::Transfer(xcb_atom_t selection, qint32 fd, xcb_timestamp_t timestamp, QObject *parent)
     : QObject(parent)
@@ -41,6 +118,21 @@ Transfer::Transfer(xcb_atom_t selection, qint32 fd, xcb_timestamp_t timestamp, Q
     , m_fd(fd)
     , m_timestamp(timestamp)
 {
+    m_elapsedTimer.start();
+
+    // A client that is slow to read or write the pipe must not block the compositor
+    const int flags = fcntl(m_fd, F_GETFL);
+    if (flags != -1) {
+        fcntl(m_fd, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+void Transfer::addTransferredBytes(qint64 count)
+{
+    if (m_latency == -1 && count > 0) {
+        m_latency = m_elapsedTimer.elapsed();
+    }
+    m_bytesTransferred += count;
 }
 
 void Transfer::createSocketNotifier(QSocketNotifier::Type type)
@@ -119,6 +211,7 @@ int TransferWltoX::flushSourceData()
     resetTimeout();
 
     const auto rm = m_chunks.takeFirst();
+    addTransferredBytes(rm.first.size());
     return rm.first.size();
 }
 
@@ -166,6 +259,12 @@ void TransferWltoX::readWlSource()
     Q_ASSERT(avail > 0);
 
     ssize_t readLen = read(fd(), m_chunks.last().first.data() + oldLen, avail);
+    if (readLen == -1 && isTemporaryError(errno)) {
+        if (m_chunks.last().second == 0) {
+            m_chunks.removeLast();
+        }
+        return;
+    }
     if (readLen == -1) {
         qCWarning(KWIN_XWL) << "Error reading in Wl data.";
 
@@ -207,6 +306,12 @@ void TransferWltoX::readWlSource()
             startIncr();
         }
     }
+
+    if (socketNotifier() && m_chunks.size() >= s_maxBufferedChunks) {
+        // The X client is slower than the source, stop reading until it catches up so the
+        // whole data doesn't end up in memory
+        socketNotifier()->setEnabled(false);
+    }
     resetTimeout();
 }
 
@@ -250,6 +355,9 @@ void TransferWltoX::handlePropertyDelete()
             endTransfer();
         } else if (!m_chunks.isEmpty()) {
             flushSourceData();
+            if (socketNotifier() && m_chunks.size() < s_maxBufferedChunks) {
+                socketNotifier()->setEnabled(true);
+            }
         }
     }
 }
@@ -446,13 +554,17 @@ void TransferXtoWl::dataSourceWrite()
     QByteArray property = m_receiver->data();
 
     ssize_t len = write(fd(), property.constData(), property.size());
-    if (len == -1) {
+    if (len == -1 && isTemporaryError(errno)) {
+        // the pipe is full, wait until the client reads from it
+        len = 0;
+    } else if (len == -1) {
         qCWarning(KWIN_XWL) << "X11 to Wayland write error on fd:" << fd();
         endTransfer();
         return;
     }
 
     m_receiver->partRead(len);
+    addTransferredBytes(len);
     if (len == property.size()) {
         // property completely transferred
         if (incr()) {
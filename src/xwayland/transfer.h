@@ -8,6 +8,7 @@
 */
 #pragma once
 
+#include <QElapsedTimer>
 #include <QList>
 #include <QObject>
 #include <QSocketNotifier>
@@ -54,11 +55,35 @@ public:
         return m_timestamp;
     }
 
+    /**
+     * Returns the number of bytes that have been delivered to the receiver so far.
+     */
+    qint64 bytesTransferred() const
+    {
+        return m_bytesTransferred;
+    }
+    /**
+     * Returns the time in milliseconds since the transfer has been started.
+     */
+    qint64 elapsed() const
+    {
+        return m_elapsedTimer.elapsed();
+    }
+    /**
+     * Returns the time in milliseconds it took to deliver the first data to the receiver,
+     * or -1 if no data has been delivered yet.
+     */
+    qint64 latency() const
+    {
+        return m_latency;
+    }
+
 Q_SIGNALS:
     void finished();
 
 protected:
     void endTransfer();
+    void addTransferredBytes(qint64 count);
 
     xcb_atom_t atom() const
     {
@@ -95,6 +120,10 @@ private:
     qint32 m_fd;
     xcb_timestamp_t m_timestamp = XCB_CURRENT_TIME;
 
+    QElapsedTimer m_elapsedTimer;
+    qint64 m_bytesTransferred = 0;
+    qint64 m_latency = -1;
+
     QSocketNotifier *m_notifier = nullptr;
     bool m_incr = false;
     bool m_timeout = false;
@@ -102,6 +131,65 @@ private:
     Q_DISABLE_COPY(Transfer)
 };
 
+/**
+ * Collects statistics about the transfers of a data bridge, they're shown in the debug console.
+ */
+class TransferStatistics : public QObject
+{
+    Q_OBJECT
+    /**
+     * The number of transfers in progress.
+     */
+    Q_PROPERTY(int activeTransfers READ activeTransfers)
+    /**
+     * The number of finished transfers.
+     */
+    Q_PROPERTY(quint64 finishedTransfers READ finishedTransfers)
+    /**
+     * The total number of bytes sent from Wayland to X11 clients.
+     */
+    Q_PROPERTY(quint64 bytesToX READ bytesToX)
+    /**
+     * The total number of bytes sent from X11 to Wayland clients.
+     */
+    Q_PROPERTY(quint64 bytesToWayland READ bytesToWayland)
+    /**
+     * The throughput of the last finished transfer, in KiB/s.
+     */
+    Q_PROPERTY(qint64 lastThroughput READ lastThroughput)
+    /**
+     * The time it took the last finished transfer to deliver its first data, in milliseconds.
+     */
+    Q_PROPERTY(qint64 lastLatency READ lastLatency)
+    /**
+     * The longest time a transfer took to deliver its first data, in milliseconds.
+     */
+    Q_PROPERTY(qint64 maxLatency READ maxLatency)
+
+public:
+    explicit TransferStatistics(QObject *parent = nullptr);
+
+    void transferStarted();
+    void transferFinished(const Transfer *transfer);
+
+    int activeTransfers() const;
+    quint64 finishedTransfers() const;
+    quint64 bytesToX() const;
+    quint64 bytesToWayland() const;
+    qint64 lastThroughput() const;
+    qint64 lastLatency() const;
+    qint64 maxLatency() const;
+
+private:
+    int m_activeTransfers = 0;
+    quint64 m_finishedTransfers = 0;
+    quint64 m_bytesToX = 0;
+    quint64 m_bytesToWayland = 0;
+    qint64 m_lastThroughput = 0;
+    qint64 m_lastLatency = 0;
+    qint64 m_maxLatency = 0;
+};
+
 /**
  * Represents a transfer from a Wayland native source to an X window.
  */